@@ -5,49 +5,91 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../Src/archive.c \
 ../Src/bme280.c \
 ../Src/buffer.c \
+../Src/cpu.c \
+../Src/crc.c \
 ../Src/data_acquisition.c \
+../Src/flash.c \
+../Src/flash_log.c \
 ../Src/fsm.c \
 ../Src/i2c.c \
+../Src/log.c \
+../Src/log_format.c \
 ../Src/main.c \
+../Src/power.c \
+../Src/profiler.c \
 ../Src/pwm.c \
+../Src/scheduler.c \
 ../Src/spi.c \
+../Src/statistics.c \
 ../Src/switch.c \
 ../Src/syscalls.c \
 ../Src/sysmem.c \
 ../Src/systick.c \
-../Src/timer.c 
+../Src/telemetry.c \
+../Src/timer.c \
+../Src/ts_codec.c \
+../Src/uart.c 
 
 OBJS += \
+./Src/archive.o \
 ./Src/bme280.o \
 ./Src/buffer.o \
+./Src/cpu.o \
+./Src/crc.o \
 ./Src/data_acquisition.o \
+./Src/flash.o \
+./Src/flash_log.o \
 ./Src/fsm.o \
 ./Src/i2c.o \
+./Src/log.o \
+./Src/log_format.o \
 ./Src/main.o \
+./Src/power.o \
+./Src/profiler.o \
 ./Src/pwm.o \
+./Src/scheduler.o \
 ./Src/spi.o \
+./Src/statistics.o \
 ./Src/switch.o \
 ./Src/syscalls.o \
 ./Src/sysmem.o \
 ./Src/systick.o \
-./Src/timer.o 
+./Src/telemetry.o \
+./Src/timer.o \
+./Src/ts_codec.o \
+./Src/uart.o 
 
 C_DEPS += \
+./Src/archive.d \
 ./Src/bme280.d \
 ./Src/buffer.d \
+./Src/cpu.d \
+./Src/crc.d \
 ./Src/data_acquisition.d \
+./Src/flash.d \
+./Src/flash_log.d \
 ./Src/fsm.d \
 ./Src/i2c.d \
+./Src/log.d \
+./Src/log_format.d \
 ./Src/main.d \
+./Src/power.d \
+./Src/profiler.d \
 ./Src/pwm.d \
+./Src/scheduler.d \
 ./Src/spi.d \
+./Src/statistics.d \
 ./Src/switch.d \
 ./Src/syscalls.d \
 ./Src/sysmem.d \
 ./Src/systick.d \
-./Src/timer.d 
+./Src/telemetry.d \
+./Src/timer.d \
+./Src/ts_codec.d \
+./Src/uart.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -57,7 +99,7 @@ Src/%.o Src/%.su Src/%.cyclo: ../Src/%.c Src/subdir.mk
 clean: clean-Src
 
 clean-Src:
-	-$(RM) ./Src/bme280.cyclo ./Src/bme280.d ./Src/bme280.o ./Src/bme280.su ./Src/buffer.cyclo ./Src/buffer.d ./Src/buffer.o ./Src/buffer.su ./Src/data_acquisition.cyclo ./Src/data_acquisition.d ./Src/data_acquisition.o ./Src/data_acquisition.su ./Src/fsm.cyclo ./Src/fsm.d ./Src/fsm.o ./Src/fsm.su ./Src/i2c.cyclo ./Src/i2c.d ./Src/i2c.o ./Src/i2c.su ./Src/main.cyclo ./Src/main.d ./Src/main.o ./Src/main.su ./Src/pwm.cyclo ./Src/pwm.d ./Src/pwm.o ./Src/pwm.su ./Src/spi.cyclo ./Src/spi.d ./Src/spi.o ./Src/spi.su ./Src/switch.cyclo ./Src/switch.d ./Src/switch.o ./Src/switch.su ./Src/syscalls.cyclo ./Src/syscalls.d ./Src/syscalls.o ./Src/syscalls.su ./Src/sysmem.cyclo ./Src/sysmem.d ./Src/sysmem.o ./Src/sysmem.su ./Src/systick.cyclo ./Src/systick.d ./Src/systick.o ./Src/systick.su ./Src/timer.cyclo ./Src/timer.d ./Src/timer.o ./Src/timer.su
+	-$(RM) ./Src/archive.cyclo ./Src/archive.d ./Src/archive.o ./Src/archive.su ./Src/bme280.cyclo ./Src/bme280.d ./Src/bme280.o ./Src/bme280.su ./Src/buffer.cyclo ./Src/buffer.d ./Src/buffer.o ./Src/buffer.su ./Src/cpu.cyclo ./Src/cpu.d ./Src/cpu.o ./Src/cpu.su ./Src/crc.cyclo ./Src/crc.d ./Src/crc.o ./Src/crc.su ./Src/data_acquisition.cyclo ./Src/data_acquisition.d ./Src/data_acquisition.o ./Src/data_acquisition.su ./Src/flash.cyclo ./Src/flash.d ./Src/flash.o ./Src/flash.su ./Src/flash_log.cyclo ./Src/flash_log.d ./Src/flash_log.o ./Src/flash_log.su ./Src/fsm.cyclo ./Src/fsm.d ./Src/fsm.o ./Src/fsm.su ./Src/i2c.cyclo ./Src/i2c.d ./Src/i2c.o ./Src/i2c.su ./Src/log.cyclo ./Src/log.d ./Src/log.o ./Src/log.su ./Src/log_format.cyclo ./Src/log_format.d ./Src/log_format.o ./Src/log_format.su ./Src/main.cyclo ./Src/main.d ./Src/main.o ./Src/main.su ./Src/power.cyclo ./Src/power.d ./Src/power.o ./Src/power.su ./Src/profiler.cyclo ./Src/profiler.d ./Src/profiler.o ./Src/profiler.su ./Src/pwm.cyclo ./Src/pwm.d ./Src/pwm.o ./Src/pwm.su ./Src/scheduler.cyclo ./Src/scheduler.d ./Src/scheduler.o ./Src/scheduler.su ./Src/spi.cyclo ./Src/spi.d ./Src/spi.o ./Src/spi.su ./Src/statistics.cyclo ./Src/statistics.d ./Src/statistics.o ./Src/statistics.su ./Src/switch.cyclo ./Src/switch.d ./Src/switch.o ./Src/switch.su ./Src/syscalls.cyclo ./Src/syscalls.d ./Src/syscalls.o ./Src/syscalls.su ./Src/sysmem.cyclo ./Src/sysmem.d ./Src/sysmem.o ./Src/sysmem.su ./Src/systick.cyclo ./Src/systick.d ./Src/systick.o ./Src/systick.su ./Src/telemetry.cyclo ./Src/telemetry.d ./Src/telemetry.o ./Src/telemetry.su ./Src/timer.cyclo ./Src/timer.d ./Src/timer.o ./Src/timer.su ./Src/ts_codec.cyclo ./Src/ts_codec.d ./Src/ts_codec.o ./Src/ts_codec.su ./Src/uart.cyclo ./Src/uart.d ./Src/uart.o ./Src/uart.su
 
 .PHONY: clean-Src
 
@@ -0,0 +1,307 @@
+/**
+ * @file    bench.c
+ * @brief   Micro-benchmarks of the per-sample firmware kernels.
+ *
+ * Runs each kernel over a table of synthetic samples and reports the time
+ * and, where the operating system allows it (perf_event_open), the number of
+ * retired host instructions per operation:
+ *   comp_temp   BME280_CompensateTemp()
+ *   comp_press  BME280_CompensatePressure()
+ *   comp_hum    BME280_CompensateHumidity()
+ *   ring        ring_push() + ring_pop() of a BME280_FixedData
+ *   moving_avg  the averaging window update of acquire_data(): drop the
+ *               oldest sample, add the new one, divide
+ *   statistics  statistics_add_sample()
+ *
+ * The numbers are for the host CPU; compare them between two builds, not
+ * with the target. `make bench-arm` runs the same kernels as a Cortex-M0
+ * (Thumb-1) binary under qemu-arm and counts the ARMv6-M instructions per
+ * operation, a closer estimate of the cycle cost on the target.
+ *
+ * Usage: bench_host [-n iterations] [-k kernel]
+ *   -n  operations per kernel (default 10000000)
+ *   -k  run only this kernel, without timing; used by make bench-arm
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "bme280.h"
+#include "buffer.h"
+#include "statistics.h"
+#include "bme280_model.h"
+
+#define INPUTS        1024   // Synthetic samples, cycled through
+#define WINDOW        60     // NUM_SAMPLES of data_acquisition.c
+
+typedef void (*Kernel)(uint32_t n);
+
+typedef struct
+{
+   const char *name;
+   Kernel run;
+} Benchmark;
+
+RING_BUFFER_DEFINE(bench_ring, BME280_FixedData, WINDOW);
+
+static BME280_Dev dev;
+static BME280_RawData raw[INPUTS];
+static BME280_FixedData samples[INPUTS];
+static volatile uint32_t sink;   // Keeps results alive
+
+/**
+ * @brief Fills the input tables with raw values around 21 °C, 1013 hPa and
+ *        45 %RH, and their compensated samples.
+ */
+static void make_inputs(void)
+{
+   const BME280_ModelCalib *c = &bme280_model_default_calib;
+   uint32_t seed = 12345;
+
+   dev.calib = (BME280_CalibData){
+      c->dig_T1, c->dig_T2, c->dig_T3,
+      c->dig_P1, c->dig_P2, c->dig_P3, c->dig_P4, c->dig_P5, c->dig_P6, c->dig_P7, c->dig_P8, c->dig_P9,
+      c->dig_H1, c->dig_H2, c->dig_H3, c->dig_H4, c->dig_H5, c->dig_H6
+   };
+
+   for (uint32_t i = 0; i < INPUTS; i++)
+   {
+      seed = seed * 1103515245u + 12345u;
+      raw[i].adc_T = 519888 + (int32_t)((seed >> 8) % 40000) - 20000;
+      raw[i].adc_P = 415148 + (int32_t)((seed >> 4) % 60000) - 30000;
+      raw[i].adc_H = 30000 + (int32_t)((seed >> 12) % 10000) - 5000;
+      BME280_Compensate(&dev, &raw[i], &samples[i]);
+   }
+}
+
+static void kernel_comp_temp(uint32_t n)
+{
+   uint32_t acc = 0;
+
+   for (uint32_t i = 0; i < n; i++)
+   {
+      acc += (uint32_t)BME280_CompensateTemp(&dev, raw[i % INPUTS].adc_T);
+   }
+   sink = acc;
+}
+
+static void kernel_comp_press(uint32_t n)
+{
+   uint32_t acc = 0;
+
+   BME280_CompensateTemp(&dev, raw[0].adc_T);
+   for (uint32_t i = 0; i < n; i++)
+   {
+      acc += BME280_CompensatePressure(&dev, raw[i % INPUTS].adc_P);
+   }
+   sink = acc;
+}
+
+static void kernel_comp_hum(uint32_t n)
+{
+   uint32_t acc = 0;
+
+   BME280_CompensateTemp(&dev, raw[0].adc_T);
+   for (uint32_t i = 0; i < n; i++)
+   {
+      acc += BME280_CompensateHumidity(&dev, raw[i % INPUTS].adc_H);
+   }
+   sink = acc;
+}
+
+static void kernel_ring(uint32_t n)
+{
+   BME280_FixedData out;
+   uint32_t acc = 0;
+
+   ring_reset(&bench_ring);
+   for (uint32_t i = 0; i < n; i++)
+   {
+      ring_push(&bench_ring, &samples[i % INPUTS]);
+      ring_pop(&bench_ring, &out);
+      acc += (uint32_t)out.temperature;
+   }
+   sink = acc;
+}
+
+static void kernel_moving_avg(uint32_t n)
+{
+   int32_t running_sum = 0;
+   int32_t avg = 0;
+
+   ring_reset(&bench_ring);
+   for (uint32_t i = 0; i < n; i++)
+   {
+      const BME280_FixedData *data = &samples[i % INPUTS];
+
+      if (ring_is_full(&bench_ring))
+      {
+         BME280_FixedData old_sample;
+         ring_pop(&bench_ring, &old_sample);
+         running_sum -= old_sample.temperature;
+      }
+      ring_push(&bench_ring, data);
+      running_sum += data->temperature;
+      avg = running_sum / ring_length(&bench_ring);
+   }
+   sink = (uint32_t)avg;
+}
+
+static void kernel_statistics(uint32_t n)
+{
+   Init_Statistics();
+   for (uint32_t i = 0; i < n; i++)
+   {
+      statistics_add_sample(&samples[i % INPUTS]);
+   }
+}
+
+static const Benchmark benchmarks[] = {
+   { "comp_temp", kernel_comp_temp },
+   { "comp_press", kernel_comp_press },
+   { "comp_hum", kernel_comp_hum },
+   { "ring", kernel_ring },
+   { "moving_avg", kernel_moving_avg },
+   { "statistics", kernel_statistics },
+};
+
+#define NUM_BENCHMARKS (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+static uint64_t now_ns(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Opens a counter of the instructions retired by this process in
+ *        user mode.
+ *
+ * @return int File descriptor, or -1 if the counter is not available.
+ */
+static int open_instruction_counter(void)
+{
+#ifdef __linux__
+   struct perf_event_attr attr;
+
+   memset(&attr, 0, sizeof(attr));
+   attr.size = sizeof(attr);
+   attr.type = PERF_TYPE_HARDWARE;
+   attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+   attr.disabled = 1;
+   attr.exclude_kernel = 1;
+   attr.exclude_hv = 1;
+   return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+   return -1;
+#endif
+}
+
+static void counter_start(int fd)
+{
+#ifdef __linux__
+   if (fd >= 0)
+   {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+   }
+#endif
+}
+
+static uint64_t counter_stop(int fd)
+{
+   uint64_t count = 0;
+
+#ifdef __linux__
+   if (fd >= 0)
+   {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd, &count, sizeof(count)) != sizeof(count))
+      {
+         count = 0;
+      }
+   }
+#endif
+   return count;
+}
+
+int main(int argc, char *argv[])
+{
+   uint32_t n = 10000000;
+   const char *only = NULL;
+   int counter;
+   int opt;
+
+   while ((opt = getopt(argc, argv, "n:k:")) != -1)
+   {
+      switch (opt)
+      {
+      case 'n':
+         n = strtoul(optarg, NULL, 0);
+         break;
+      case 'k':
+         only = optarg;
+         break;
+      default:
+         fprintf(stderr, "usage: %s [-n iterations] [-k kernel]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   make_inputs();
+
+   if (only != NULL)
+   {
+      for (uint32_t b = 0; b < NUM_BENCHMARKS; b++)
+      {
+         if (strcmp(benchmarks[b].name, only) == 0)
+         {
+            benchmarks[b].run(n);
+            return 0;
+         }
+      }
+      fprintf(stderr, "unknown kernel %s\n", only);
+      return 1;
+   }
+
+   counter = open_instruction_counter();
+   printf("%-12s %12s %10s %12s\n", "kernel", "operations", "ns/op", "instr/op");
+   for (uint32_t b = 0; b < NUM_BENCHMARKS; b++)
+   {
+      uint64_t start, elapsed, instructions;
+
+      benchmarks[b].run(n / 100 + 1);   // Warm caches and branch predictors
+      counter_start(counter);
+      start = now_ns();
+      benchmarks[b].run(n);
+      elapsed = now_ns() - start;
+      instructions = counter_stop(counter);
+
+      printf("%-12s %12lu %10.2f", benchmarks[b].name, (unsigned long)n, (double)elapsed / n);
+      if (counter >= 0)
+      {
+         printf(" %12.1f\n", (double)instructions / n);
+      }
+      else
+      {
+         printf(" %12s\n", "n/a");
+      }
+   }
+   if (counter < 0)
+   {
+      fprintf(stderr, "instruction counter not available (perf_event_paranoid?)\n");
+   }
+   return 0;
+}
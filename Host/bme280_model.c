@@ -0,0 +1,359 @@
+/**
+ * @file    bme280_model.c
+ * @brief   Register-level model of the Bosch BME280 used by the host build.
+ *
+ * Raw ADC values are derived from the simulated environment by bisecting the
+ * datasheet's double-precision compensation formulas (section 8.1), which
+ * are monotonic in the ADC value for valid calibration data.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ * Reference:
+ * 1. https://www.bosch-sensortec.com/media/boschsensortec/downloads/datasheets/bst-bme280-ds002.pdf
+ */
+#include <stddef.h>
+#include <string.h>
+#include "bme280_model.h"
+
+#define REG_CALIB_00     0x88
+#define REG_CALIB_H1     0xA1
+#define REG_CHIP_ID      0xD0
+#define REG_RESET        0xE0
+#define REG_CALIB_26     0xE1
+#define REG_CTRL_HUM     0xF2
+#define REG_STATUS       0xF3
+#define REG_CTRL_MEAS    0xF4
+#define REG_CONFIG       0xF5
+#define REG_PRESS_MSB    0xF7
+
+#define CHIP_ID          0x60
+#define RESET_COMMAND    0xB6
+#define ADC_20BIT_MAX    0xFFFFF
+#define ADC_16BIT_MAX    0xFFFF
+
+// Calibration values from a production sensor (datasheet example for T/P)
+const BME280_ModelCalib bme280_model_default_calib = {
+   .dig_T1 = 27504, .dig_T2 = 26435, .dig_T3 = -1000,
+   .dig_P1 = 36477, .dig_P2 = -10685, .dig_P3 = 3024,
+   .dig_P4 = 2855,  .dig_P5 = 140,    .dig_P6 = -7,
+   .dig_P7 = 15500, .dig_P8 = -14600, .dig_P9 = 6000,
+   .dig_H1 = 75,    .dig_H2 = 370,    .dig_H3 = 0,
+   .dig_H4 = 292,   .dig_H5 = 50,     .dig_H6 = 30
+};
+
+static BME280_Model sensors[BME280_MODEL_MAX_SENSORS];
+static uint8_t num_sensors;
+
+/**
+ * @brief Stores a 16-bit calibration word little-endian at reg.
+ */
+static void put_le16(BME280_Model *model, uint8_t reg, uint16_t value)
+{
+   model->regs[reg] = value & 0xFF;
+   model->regs[reg + 1] = value >> 8;
+}
+
+/**
+ * @brief Restores the power-on register contents.
+ */
+static void power_on_reset(BME280_Model *model)
+{
+   const BME280_ModelCalib *c = &model->calib;
+
+   memset(model->regs, 0, sizeof(model->regs));
+   model->regs[REG_CHIP_ID] = CHIP_ID;
+
+   put_le16(model, 0x88, c->dig_T1);
+   put_le16(model, 0x8A, (uint16_t)c->dig_T2);
+   put_le16(model, 0x8C, (uint16_t)c->dig_T3);
+   put_le16(model, 0x8E, c->dig_P1);
+   put_le16(model, 0x90, (uint16_t)c->dig_P2);
+   put_le16(model, 0x92, (uint16_t)c->dig_P3);
+   put_le16(model, 0x94, (uint16_t)c->dig_P4);
+   put_le16(model, 0x96, (uint16_t)c->dig_P5);
+   put_le16(model, 0x98, (uint16_t)c->dig_P6);
+   put_le16(model, 0x9A, (uint16_t)c->dig_P7);
+   put_le16(model, 0x9C, (uint16_t)c->dig_P8);
+   put_le16(model, 0x9E, (uint16_t)c->dig_P9);
+   model->regs[REG_CALIB_H1] = c->dig_H1;
+
+   put_le16(model, REG_CALIB_26, (uint16_t)c->dig_H2);
+   model->regs[0xE3] = c->dig_H3;
+   model->regs[0xE4] = (uint8_t)((uint16_t)c->dig_H4 >> 4);
+   model->regs[0xE5] = ((uint16_t)c->dig_H4 & 0x0F) | (((uint16_t)c->dig_H5 & 0x0F) << 4);
+   model->regs[0xE6] = (uint8_t)((uint16_t)c->dig_H5 >> 4);
+   model->regs[0xE7] = (uint8_t)c->dig_H6;
+
+   // Data registers hold the reset values 0x80000 / 0x8000 until a conversion
+   model->regs[0xF7] = 0x80;
+   model->regs[0xFA] = 0x80;
+   model->regs[0xFD] = 0x80;
+}
+
+/**
+ * @brief Finds the ADC code whose compensated value is closest to target.
+ *
+ * @param increasing true if the compensated value grows with the ADC code.
+ */
+static int32_t bisect(const BME280_Model *model, double target, int32_t hi,
+                      bool increasing,
+                      double (*eval)(const BME280_Model *, int32_t))
+{
+   int32_t lo = 0;
+
+   while (lo < hi)
+   {
+      int32_t mid = lo + (hi - lo) / 2;
+      double value = eval(model, mid);
+      if ((value < target) == increasing)
+      {
+         lo = mid + 1;
+      }
+      else
+      {
+         hi = mid;
+      }
+   }
+   return lo;
+}
+
+static double eval_temp(const BME280_Model *model, int32_t adc)
+{
+   return bme280_model_compensate_temp(&model->calib, adc, NULL);
+}
+
+static double eval_pressure(const BME280_Model *model, int32_t adc)
+{
+   double t_fine;
+   int32_t adc_T = ((int32_t)model->regs[0xFA] << 12) | ((int32_t)model->regs[0xFB] << 4) |
+                   (model->regs[0xFC] >> 4);
+   bme280_model_compensate_temp(&model->calib, adc_T, &t_fine);
+   return bme280_model_compensate_pressure(&model->calib, adc, t_fine);
+}
+
+static double eval_humidity(const BME280_Model *model, int32_t adc)
+{
+   double t_fine;
+   int32_t adc_T = ((int32_t)model->regs[0xFA] << 12) | ((int32_t)model->regs[0xFB] << 4) |
+                   (model->regs[0xFC] >> 4);
+   bme280_model_compensate_temp(&model->calib, adc_T, &t_fine);
+   return bme280_model_compensate_humidity(&model->calib, adc, t_fine);
+}
+
+/**
+ * @brief Latches a new conversion of the current environment into 0xF7..0xFE.
+ */
+static void convert(BME280_Model *model)
+{
+   int32_t adc_T = bisect(model, model->temperature, ADC_20BIT_MAX, true, eval_temp);
+   model->regs[0xFA] = (adc_T >> 12) & 0xFF;
+   model->regs[0xFB] = (adc_T >> 4) & 0xFF;
+   model->regs[0xFC] = (adc_T << 4) & 0xF0;
+
+   int32_t adc_P = bisect(model, model->pressure, ADC_20BIT_MAX, false, eval_pressure);
+   model->regs[0xF7] = (adc_P >> 12) & 0xFF;
+   model->regs[0xF8] = (adc_P >> 4) & 0xFF;
+   model->regs[0xF9] = (adc_P << 4) & 0xF0;
+
+   int32_t adc_H = bisect(model, model->humidity, ADC_16BIT_MAX, true, eval_humidity);
+   model->regs[0xFD] = (adc_H >> 8) & 0xFF;
+   model->regs[0xFE] = adc_H & 0xFF;
+}
+
+/**
+ * @brief Adds a sensor to the simulated bus.
+ *
+ * @param address 7-bit I2C address or SPI chip-select pin the sensor
+ *                answers to.
+ * @param calib    Calibration set, or NULL for bme280_model_default_calib.
+ * @return Pointer to the model, or NULL if all slots are used.
+ */
+BME280_Model *bme280_model_attach(uint8_t address, const BME280_ModelCalib *calib)
+{
+   if (num_sensors == BME280_MODEL_MAX_SENSORS)
+   {
+      return NULL;
+   }
+
+   BME280_Model *model = &sensors[num_sensors++];
+   model->address = address;
+   model->calib = (calib != NULL) ? *calib : bme280_model_default_calib;
+   model->temperature = 20.0;
+   model->pressure = 101325.0;
+   model->humidity = 40.0;
+   power_on_reset(model);
+   return model;
+}
+
+/**
+ * @brief Looks up the sensor answering to an I2C address or SPI chip select.
+ *
+ * @return Pointer to the model, or NULL if no sensor would ACK.
+ */
+BME280_Model *bme280_model_find(uint8_t address)
+{
+   for (uint8_t i = 0; i < num_sensors; i++)
+   {
+      if (sensors[i].address == address)
+      {
+         return &sensors[i];
+      }
+   }
+   return NULL;
+}
+
+/**
+ * @brief Returns the sensor attached in position index, or NULL.
+ */
+BME280_Model *bme280_model_get(uint8_t index)
+{
+   return (index < num_sensors) ? &sensors[index] : NULL;
+}
+
+/**
+ * @brief Detaches all sensors.
+ */
+void bme280_model_reset_all(void)
+{
+   num_sensors = 0;
+}
+
+/**
+ * @brief Sets the conditions the sensor will measure on its next conversion.
+ *
+ * @param temperature Temperature in °C.
+ * @param pressure    Pressure in Pa.
+ * @param humidity    Relative humidity in %.
+ */
+void bme280_model_set_environment(BME280_Model *model, double temperature,
+                                  double pressure, double humidity)
+{
+   model->temperature = temperature;
+   model->pressure = pressure;
+   model->humidity = humidity;
+}
+
+/**
+ * @brief Reads one register, as seen by the bus master.
+ *
+ * Reading the first data register starts a burst, so a fresh conversion is
+ * latched when 0xF7 is accessed in normal mode. In sleep mode the data
+ * registers keep the result of the last forced conversion.
+ */
+uint8_t bme280_model_read(BME280_Model *model, uint8_t reg)
+{
+   if ((reg == REG_PRESS_MSB) && ((model->regs[REG_CTRL_MEAS] & 0x03) == 0x03))
+   {
+      convert(model);
+   }
+   return model->regs[reg];
+}
+
+/**
+ * @brief Writes one register, as seen by the bus master.
+ *
+ * Only the control registers and the reset register are writable. Selecting
+ * forced mode converts immediately and returns the model to sleep mode, so
+ * STATUS never reports a running conversion.
+ */
+void bme280_model_write(BME280_Model *model, uint8_t reg, uint8_t value)
+{
+   switch (reg)
+   {
+   case REG_RESET:
+      if (value == RESET_COMMAND)
+      {
+         power_on_reset(model);
+      }
+      break;
+   case REG_CTRL_MEAS:
+      model->regs[reg] = value;
+      if ((value & 0x03) == 0x01 || (value & 0x03) == 0x02)
+      {
+         convert(model);
+         model->regs[reg] &= ~0x03;
+      }
+      break;
+   case REG_CTRL_HUM:
+   case REG_CONFIG:
+      model->regs[reg] = value;
+      break;
+   default:
+      break;
+   }
+}
+
+/**
+ * @brief Datasheet floating-point temperature compensation.
+ *
+ * @param[out] t_fine Fine temperature carried into P/H compensation, may be NULL.
+ * @return Temperature in °C.
+ */
+double bme280_model_compensate_temp(const BME280_ModelCalib *calib, int32_t adc_T, double *t_fine)
+{
+   double var1, var2;
+
+   var1 = (((double)adc_T) / 16384.0 - ((double)calib->dig_T1) / 1024.0) *
+          ((double)calib->dig_T2);
+   var2 = ((((double)adc_T) / 131072.0 - ((double)calib->dig_T1) / 8192.0) *
+           (((double)adc_T) / 131072.0 - ((double)calib->dig_T1) / 8192.0)) *
+          ((double)calib->dig_T3);
+   if (t_fine != NULL)
+   {
+      *t_fine = var1 + var2;
+   }
+   return (var1 + var2) / 5120.0;
+}
+
+/**
+ * @brief Datasheet floating-point pressure compensation.
+ *
+ * @return Pressure in Pa.
+ */
+double bme280_model_compensate_pressure(const BME280_ModelCalib *calib, int32_t adc_P, double t_fine)
+{
+   double var1, var2, p;
+
+   var1 = (t_fine / 2.0) - 64000.0;
+   var2 = var1 * var1 * ((double)calib->dig_P6) / 32768.0;
+   var2 = var2 + var1 * ((double)calib->dig_P5) * 2.0;
+   var2 = (var2 / 4.0) + (((double)calib->dig_P4) * 65536.0);
+   var1 = (((double)calib->dig_P3) * var1 * var1 / 524288.0 +
+           ((double)calib->dig_P2) * var1) / 524288.0;
+   var1 = (1.0 + var1 / 32768.0) * ((double)calib->dig_P1);
+   if (var1 == 0.0)
+   {
+      return 0.0;
+   }
+   p = 1048576.0 - (double)adc_P;
+   p = (p - (var2 / 4096.0)) * 6250.0 / var1;
+   var1 = ((double)calib->dig_P9) * p * p / 2147483648.0;
+   var2 = p * ((double)calib->dig_P8) / 32768.0;
+   return p + (var1 + var2 + ((double)calib->dig_P7)) / 16.0;
+}
+
+/**
+ * @brief Datasheet floating-point humidity compensation.
+ *
+ * @return Relative humidity in %, clamped to 0..100.
+ */
+double bme280_model_compensate_humidity(const BME280_ModelCalib *calib, int32_t adc_H, double t_fine)
+{
+   double var_H;
+
+   var_H = t_fine - 76800.0;
+   var_H = (adc_H - (((double)calib->dig_H4) * 64.0 + ((double)calib->dig_H5) / 16384.0 * var_H)) *
+           (((double)calib->dig_H2) / 65536.0 *
+            (1.0 + ((double)calib->dig_H6) / 67108864.0 * var_H *
+                       (1.0 + ((double)calib->dig_H3) / 67108864.0 * var_H)));
+   var_H = var_H * (1.0 - ((double)calib->dig_H1) * var_H / 524288.0);
+   if (var_H > 100.0)
+   {
+      var_H = 100.0;
+   }
+   else if (var_H < 0.0)
+   {
+      var_H = 0.0;
+   }
+   return var_H;
+}
@@ -0,0 +1,72 @@
+#ifndef __BME280_MODEL_H__
+#define __BME280_MODEL_H__
+
+/**
+ * @file    bme280_model.h
+ * @brief   Register-level model of the Bosch BME280 used by the host build.
+ *
+ * The model exposes the same register map as the real sensor (chip ID,
+ * reset, control, calibration and measurement registers). Measurement
+ * registers are filled with the raw ADC values that the datasheet's
+ * floating-point compensation formulas map back to the simulated
+ * environment, so the firmware's integer compensation runs on realistic
+ * data.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BME280_MODEL_MAX_SENSORS 4
+
+// Factory calibration words as stored in registers 0x88..0xA1 / 0xE1..0xE7
+typedef struct
+{
+   uint16_t dig_T1;
+   int16_t  dig_T2;
+   int16_t  dig_T3;
+   uint16_t dig_P1;
+   int16_t  dig_P2;
+   int16_t  dig_P3;
+   int16_t  dig_P4;
+   int16_t  dig_P5;
+   int16_t  dig_P6;
+   int16_t  dig_P7;
+   int16_t  dig_P8;
+   int16_t  dig_P9;
+   uint8_t  dig_H1;
+   int16_t  dig_H2;
+   uint8_t  dig_H3;
+   int16_t  dig_H4;
+   int16_t  dig_H5;
+   int8_t   dig_H6;
+} BME280_ModelCalib;
+
+typedef struct
+{
+   uint8_t address;            // I2C address (0x76/0x77) or SPI CS pin
+   uint8_t regs[256];
+   BME280_ModelCalib calib;
+   double temperature;         // °C
+   double pressure;            // Pa
+   double humidity;            // %RH
+} BME280_Model;
+
+extern const BME280_ModelCalib bme280_model_default_calib;
+
+BME280_Model *bme280_model_attach(uint8_t address, const BME280_ModelCalib *calib);
+BME280_Model *bme280_model_find(uint8_t address);
+BME280_Model *bme280_model_get(uint8_t index);
+void bme280_model_reset_all(void);
+void bme280_model_set_environment(BME280_Model *model, double temperature,
+                                  double pressure, double humidity);
+uint8_t bme280_model_read(BME280_Model *model, uint8_t reg);
+void bme280_model_write(BME280_Model *model, uint8_t reg, uint8_t value);
+
+double bme280_model_compensate_temp(const BME280_ModelCalib *calib, int32_t adc_T, double *t_fine);
+double bme280_model_compensate_pressure(const BME280_ModelCalib *calib, int32_t adc_P, double t_fine);
+double bme280_model_compensate_humidity(const BME280_ModelCalib *calib, int32_t adc_H, double t_fine);
+
+#endif
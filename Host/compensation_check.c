@@ -0,0 +1,369 @@
+/**
+ * @file    compensation_check.c
+ * @brief   Accuracy check of the fixed-point BME280 compensation against the
+ *          datasheet's double-precision formulas.
+ *
+ * Raw ADC values are run through BME280_CompensateTemp(),
+ * BME280_CompensatePressure() and BME280_CompensateHumidity() of
+ * Src/bme280.c and through the floating-point reference of
+ * Host/bme280_model.c, and the largest difference of each channel is
+ * reported with the vector that produced it. The vectors are:
+ *  - the datasheet calibration and random variations of it, every
+ *    coefficient within +/-10 % with its sign kept,
+ *  - for each calibration, the raw values at the ends of the operating
+ *    range (-40..85 °C, 300..1100 hPa, 0..100 %RH) and their neighbours,
+ *    found by bisection of the reference,
+ *  - the raw extremes 0, 0xFFFF, 0xFFFFF and 0x80000, the value of a
+ *    skipped measurement, for temperature and pressure, and 0, 0x8000 and
+ *    0xFFFF for humidity; these and the range ends are each paired with
+ *    the raw temperatures of -40 and 85 °C,
+ *  - then uniformly random raw values between the ends of the range.
+ * Pressure and humidity each use a random raw temperature of the same
+ * range; the firmware and the reference each use their own t_fine, so the
+ * error includes what the temperature path passes on.
+ *
+ * The program exits with status 1 if a channel exceeds its limit, so it can
+ * gate a change of the compensation code: run it before and after.
+ *
+ * Usage: compensation_check [-n vectors] [-c calibrations] [-s seed]
+ *                           [-T limit_C] [-P limit_Pa] [-H limit_RH]
+ *   -n  random vectors per calibration (default 100000)
+ *   -c  calibration sets, the datasheet one included (default 16)
+ *   -s  random seed (default 1)
+ *   -T, -P, -H  error limits (default 0.01 °C, 1.0 Pa, 0.05 %RH)
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <math.h>
+#include "bme280.h"
+#include "bme280_model.h"
+
+#define ADC_20BIT_MAX   0xFFFFF
+#define ADC_16BIT_MAX   0xFFFF
+#define ADC_20BIT_SKIPPED 0x80000   // Output of a skipped measurement
+#define ADC_16BIT_SKIPPED 0x8000
+
+#define PRESS_FIXED_MAX_PA (UINT32_MAX / 256.0)   // Largest Pa/256 result
+
+#define TEMP_MIN_C      -40.0
+#define TEMP_MAX_C      85.0
+#define PRESS_MIN_PA    30000.0
+#define PRESS_MAX_PA    110000.0
+#define HUM_MIN_RH      0.0
+#define HUM_MAX_RH      100.0
+
+typedef enum
+{
+   CHANNEL_TEMPERATURE,
+   CHANNEL_PRESSURE,
+   CHANNEL_HUMIDITY,
+   CHANNEL_COUNT
+} Channel;
+
+/**
+ * @brief Largest error of one channel and where it occurred.
+ */
+typedef struct
+{
+   double max_error;
+   double sum_error;
+   unsigned long vectors;
+   uint32_t calib_index;
+   int32_t adc;
+   int32_t adc_T;
+} ChannelError;
+
+/**
+ * @brief Raw ADC range of the operating range of each channel.
+ */
+typedef struct
+{
+   int32_t low[CHANNEL_COUNT];
+   int32_t high[CHANNEL_COUNT];
+} AdcRange;
+
+static const char *const channel_names[CHANNEL_COUNT] = { "temperature", "pressure", "humidity" };
+static const char *const channel_units[CHANNEL_COUNT] = { "°C", "Pa", "%RH" };
+
+// Raw values at the ends of each ADC and of a skipped measurement, far
+// outside the operating range; humidity repeats its 16-bit maximum
+static const int32_t raw_extremes[CHANNEL_COUNT][4] = {
+   { 0, ADC_16BIT_MAX, ADC_20BIT_SKIPPED, ADC_20BIT_MAX },
+   { 0, ADC_16BIT_MAX, ADC_20BIT_SKIPPED, ADC_20BIT_MAX },
+   { 0, ADC_16BIT_SKIPPED, ADC_16BIT_MAX, ADC_16BIT_MAX },
+};
+
+static ChannelError errors[CHANNEL_COUNT];
+static uint32_t rng_state;
+
+static uint32_t rng_next(void)
+{
+   // xorshift32
+   rng_state ^= rng_state << 13;
+   rng_state ^= rng_state >> 17;
+   rng_state ^= rng_state << 5;
+   return rng_state;
+}
+
+static int32_t rng_range(int32_t low, int32_t high)
+{
+   return low + (int32_t)(rng_next() % (uint32_t)(high - low + 1));
+}
+
+/**
+ * @brief Scales a coefficient by a random factor in [0.9, 1.1], keeping its
+ *        sign and the range of its type.
+ */
+static int32_t vary(int32_t value, int32_t min, int32_t max)
+{
+   double scaled = value * (0.9 + 0.2 * (rng_next() / 4294967296.0));
+
+   if (scaled < min)
+   {
+      scaled = min;
+   }
+   if (scaled > max)
+   {
+      scaled = max;
+   }
+   return (int32_t)lround(scaled);
+}
+
+static void random_calib(BME280_ModelCalib *c)
+{
+   const BME280_ModelCalib *d = &bme280_model_default_calib;
+
+   c->dig_T1 = (uint16_t)vary(d->dig_T1, 0, UINT16_MAX);
+   c->dig_T2 = (int16_t)vary(d->dig_T2, INT16_MIN, INT16_MAX);
+   c->dig_T3 = (int16_t)vary(d->dig_T3, INT16_MIN, INT16_MAX);
+   c->dig_P1 = (uint16_t)vary(d->dig_P1, 1, UINT16_MAX);
+   c->dig_P2 = (int16_t)vary(d->dig_P2, INT16_MIN, INT16_MAX);
+   c->dig_P3 = (int16_t)vary(d->dig_P3, INT16_MIN, INT16_MAX);
+   c->dig_P4 = (int16_t)vary(d->dig_P4, INT16_MIN, INT16_MAX);
+   c->dig_P5 = (int16_t)vary(d->dig_P5, INT16_MIN, INT16_MAX);
+   c->dig_P6 = (int16_t)vary(d->dig_P6, INT16_MIN, INT16_MAX);
+   c->dig_P7 = (int16_t)vary(d->dig_P7, INT16_MIN, INT16_MAX);
+   c->dig_P8 = (int16_t)vary(d->dig_P8, INT16_MIN, INT16_MAX);
+   c->dig_P9 = (int16_t)vary(d->dig_P9, INT16_MIN, INT16_MAX);
+   c->dig_H1 = (uint8_t)vary(d->dig_H1, 0, UINT8_MAX);
+   c->dig_H2 = (int16_t)vary(d->dig_H2, INT16_MIN, INT16_MAX);
+   c->dig_H3 = (uint8_t)vary(d->dig_H3, 0, UINT8_MAX);
+   c->dig_H4 = (int16_t)vary(d->dig_H4, -2048, 2047);   // 12-bit fields
+   c->dig_H5 = (int16_t)vary(d->dig_H5, -2048, 2047);
+   c->dig_H6 = (int8_t)vary(d->dig_H6, INT8_MIN, INT8_MAX);
+}
+
+static void to_firmware_calib(const BME280_ModelCalib *c, BME280_Dev *dev)
+{
+   dev->calib = (BME280_CalibData){
+      c->dig_T1, c->dig_T2, c->dig_T3,
+      c->dig_P1, c->dig_P2, c->dig_P3, c->dig_P4, c->dig_P5, c->dig_P6, c->dig_P7, c->dig_P8, c->dig_P9,
+      c->dig_H1, c->dig_H2, c->dig_H3, c->dig_H4, c->dig_H5, c->dig_H6
+   };
+}
+
+/**
+ * @brief Reference value of a channel for a raw value.
+ *
+ * Pressure is limited to what the firmware's Pa/256 result can hold, as the
+ * firmware saturates there; only raw extremes get that far.
+ */
+static double reference(const BME280_ModelCalib *c, Channel channel, int32_t adc, int32_t adc_T)
+{
+   double t_fine;
+   double pressure;
+
+   bme280_model_compensate_temp(c, (channel == CHANNEL_TEMPERATURE) ? adc : adc_T, &t_fine);
+   switch (channel)
+   {
+   case CHANNEL_TEMPERATURE:
+      return t_fine / 5120.0;
+   case CHANNEL_PRESSURE:
+      pressure = bme280_model_compensate_pressure(c, adc, t_fine);
+      return fmin(fmax(pressure, 0.0), PRESS_FIXED_MAX_PA);
+   default:
+      return bme280_model_compensate_humidity(c, adc, t_fine);
+   }
+}
+
+/**
+ * @brief Firmware value of a channel for a raw value, in reference units.
+ */
+static double firmware(BME280_Dev *dev, Channel channel, int32_t adc, int32_t adc_T)
+{
+   int32_t temperature = BME280_CompensateTemp(dev, (channel == CHANNEL_TEMPERATURE) ? adc : adc_T);
+
+   switch (channel)
+   {
+   case CHANNEL_TEMPERATURE:
+      return temperature / 100.0;
+   case CHANNEL_PRESSURE:
+      return BME280_CompensatePressure(dev, adc) / 256.0;
+   default:
+      return BME280_CompensateHumidity(dev, adc) / 1024.0;
+   }
+}
+
+/**
+ * @brief Finds the raw value at which the reference crosses a target.
+ *
+ * @param increasing true if the reference grows with the raw value.
+ */
+static int32_t bisect(const BME280_ModelCalib *c, Channel channel, int32_t adc_T, double target,
+                      int32_t max, bool increasing)
+{
+   int32_t lo = 0, hi = max;
+
+   while (lo < hi)
+   {
+      int32_t mid = lo + (hi - lo) / 2;
+      bool below = reference(c, channel, mid, adc_T) < target;
+
+      if (below == increasing)
+      {
+         lo = mid + 1;
+      }
+      else
+      {
+         hi = mid;
+      }
+   }
+   return lo;
+}
+
+/**
+ * @brief Finds the raw range of each channel's operating range.
+ *
+ * The pressure and humidity ranges are taken at 25 °C.
+ */
+static void find_ranges(const BME280_ModelCalib *c, AdcRange *r)
+{
+   int32_t t_low = bisect(c, CHANNEL_TEMPERATURE, 0, TEMP_MIN_C, ADC_20BIT_MAX, true);
+   int32_t t_high = bisect(c, CHANNEL_TEMPERATURE, 0, TEMP_MAX_C, ADC_20BIT_MAX, true);
+   int32_t t_25 = bisect(c, CHANNEL_TEMPERATURE, 0, 25.0, ADC_20BIT_MAX, true);
+
+   r->low[CHANNEL_TEMPERATURE] = t_low;
+   r->high[CHANNEL_TEMPERATURE] = t_high;
+   // Pressure falls as the raw value rises
+   r->low[CHANNEL_PRESSURE] = bisect(c, CHANNEL_PRESSURE, t_25, PRESS_MAX_PA, ADC_20BIT_MAX, false);
+   r->high[CHANNEL_PRESSURE] = bisect(c, CHANNEL_PRESSURE, t_25, PRESS_MIN_PA, ADC_20BIT_MAX, false);
+   r->low[CHANNEL_HUMIDITY] = bisect(c, CHANNEL_HUMIDITY, t_25, HUM_MIN_RH, ADC_16BIT_MAX, true);
+   r->high[CHANNEL_HUMIDITY] = bisect(c, CHANNEL_HUMIDITY, t_25, HUM_MAX_RH, ADC_16BIT_MAX, true);
+}
+
+static void check_vector(const BME280_ModelCalib *c, BME280_Dev *dev, uint32_t calib_index,
+                         Channel channel, int32_t adc, int32_t adc_T)
+{
+   double error = fabs(firmware(dev, channel, adc, adc_T) - reference(c, channel, adc, adc_T));
+   ChannelError *e = &errors[channel];
+
+   e->sum_error += error;
+   e->vectors++;
+   if (error > e->max_error)
+   {
+      e->max_error = error;
+      e->calib_index = calib_index;
+      e->adc = adc;
+      e->adc_T = adc_T;
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned long vectors = 100000;
+   uint32_t calibrations = 16;
+   double limits[CHANNEL_COUNT] = { 0.01, 1.0, 0.05 };
+   bool failed = false;
+   int opt;
+
+   rng_state = 1;
+   while ((opt = getopt(argc, argv, "n:c:s:T:P:H:")) != -1)
+   {
+      switch (opt)
+      {
+      case 'n':
+         vectors = strtoul(optarg, NULL, 0);
+         break;
+      case 'c':
+         calibrations = strtoul(optarg, NULL, 0);
+         break;
+      case 's':
+         rng_state = strtoul(optarg, NULL, 0);
+         rng_state += (rng_state == 0);
+         break;
+      case 'T':
+         limits[CHANNEL_TEMPERATURE] = strtod(optarg, NULL);
+         break;
+      case 'P':
+         limits[CHANNEL_PRESSURE] = strtod(optarg, NULL);
+         break;
+      case 'H':
+         limits[CHANNEL_HUMIDITY] = strtod(optarg, NULL);
+         break;
+      default:
+         fprintf(stderr, "usage: %s [-n vectors] [-c calibrations] [-s seed] "
+                         "[-T limit_C] [-P limit_Pa] [-H limit_RH]\n", argv[0]);
+         return 2;
+      }
+   }
+
+   for (uint32_t k = 0; k < calibrations; k++)
+   {
+      BME280_ModelCalib calib = bme280_model_default_calib;
+      BME280_Dev dev = BME280_DEV_I2C(BME280_I2C_ADDR_PRIMARY);
+      AdcRange range;
+
+      if (k != 0)
+      {
+         random_calib(&calib);
+      }
+      to_firmware_calib(&calib, &dev);
+      find_ranges(&calib, &range);
+
+      for (Channel ch = 0; ch < CHANNEL_COUNT; ch++)
+      {
+         // Ends of the operating range and their neighbours
+         const int32_t ends[] = { range.low[ch] - 1, range.low[ch], range.low[ch] + 1,
+                                  range.high[ch] - 1, range.high[ch], range.high[ch] + 1 };
+         int32_t adc_T = range.low[CHANNEL_TEMPERATURE];
+
+         for (uint32_t i = 0; i < sizeof(ends) / sizeof(ends[0]); i++)
+         {
+            check_vector(&calib, &dev, k, ch, ends[i], adc_T);
+            check_vector(&calib, &dev, k, ch, ends[i], range.high[CHANNEL_TEMPERATURE]);
+         }
+
+         for (uint32_t i = 0; i < sizeof(raw_extremes[0]) / sizeof(raw_extremes[0][0]); i++)
+         {
+            check_vector(&calib, &dev, k, ch, raw_extremes[ch][i], adc_T);
+            check_vector(&calib, &dev, k, ch, raw_extremes[ch][i], range.high[CHANNEL_TEMPERATURE]);
+         }
+
+         for (unsigned long i = 0; i < vectors; i++)
+         {
+            adc_T = rng_range(range.low[CHANNEL_TEMPERATURE], range.high[CHANNEL_TEMPERATURE]);
+            check_vector(&calib, &dev, k, ch, rng_range(range.low[ch], range.high[ch]), adc_T);
+         }
+      }
+   }
+
+   printf("%-12s %-4s %10s %12s %12s %10s  %s\n", "channel", "unit", "vectors", "max error", "mean error", "limit",
+          "worst vector");
+   for (Channel ch = 0; ch < CHANNEL_COUNT; ch++)
+   {
+      const ChannelError *e = &errors[ch];
+      bool over = e->max_error > limits[ch];
+
+      printf("%-12s %-4s %10lu %12.6f %12.6f %10.4f  calib %lu adc %ld adc_T %ld  %s\n",
+             channel_names[ch], channel_units[ch], e->vectors, e->max_error, e->sum_error / e->vectors,
+             limits[ch], (unsigned long)e->calib_index, (long)e->adc, (long)e->adc_T, over ? "FAIL" : "ok");
+      failed |= over;
+   }
+   return failed ? 1 : 0;
+}
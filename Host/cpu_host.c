@@ -0,0 +1,27 @@
+/**
+ * @file    cpu_host.c
+ * @brief   Host implementation of the core-level services.
+ *
+ * The simulation is single-threaded and injects interrupts between
+ * scheduler passes, so critical sections need no masking and sleeping
+ * returns immediately.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include "cpu.h"
+
+uint32_t cpu_enter_critical(void)
+{
+   return 0;
+}
+
+void cpu_exit_critical(uint32_t masking_state)
+{
+   (void)masking_state;
+}
+
+void cpu_sleep(void)
+{
+}
@@ -0,0 +1,118 @@
+/**
+ * @file    flash_host.c
+ * @brief   Host implementation of the flash interface.
+ *
+ * The DATALOG region is a RAM array with the rules of the STM32F091 flash:
+ * an erase sets a page to 0xFF and a halfword that is not erased cannot be
+ * programmed. host_flash_load() and host_flash_save() keep its contents in
+ * a file, so the recovery of the log after a reset can be exercised.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include "flash.h"
+#include "host.h"
+
+#define HOST_FLASH_PAGES 32   // Same size as the DATALOG region, 64 KB
+
+static uint8_t region[HOST_FLASH_PAGES * FLASH_LOG_PAGE_SIZE];
+static bool initialized;
+
+static void host_flash_init(void)
+{
+   if (!initialized)
+   {
+      memset(region, 0xFF, sizeof(region));
+      initialized = true;
+   }
+}
+
+uint16_t flash_page_count(void)
+{
+   return HOST_FLASH_PAGES;
+}
+
+const uint8_t *flash_page_address(uint16_t page)
+{
+   host_flash_init();
+   return &region[(uint32_t)page * FLASH_LOG_PAGE_SIZE];
+}
+
+bool flash_erase_page(uint16_t page)
+{
+   if (page >= HOST_FLASH_PAGES)
+   {
+      return false;
+   }
+   host_flash_init();
+   memset(&region[(uint32_t)page * FLASH_LOG_PAGE_SIZE], 0xFF, FLASH_LOG_PAGE_SIZE);
+   return true;
+}
+
+bool flash_program(uint16_t page, uint16_t offset, const void *data, uint16_t length)
+{
+   uint8_t *dest;
+
+   if ((page >= HOST_FLASH_PAGES) || (offset & 1) || (length & 1) ||
+       ((uint32_t)offset + length > FLASH_LOG_PAGE_SIZE))
+   {
+      return false;
+   }
+   host_flash_init();
+   dest = &region[(uint32_t)page * FLASH_LOG_PAGE_SIZE + offset];
+   for (uint16_t i = 0; i < length; i += 2)
+   {
+      if ((dest[i] != 0xFF) || (dest[i + 1] != 0xFF))
+      {
+         return false;   // PGERR
+      }
+   }
+   memcpy(dest, data, length);
+   return true;
+}
+
+/**
+ * @brief Loads the DATALOG region from a file written by host_flash_save().
+ *
+ * @return bool false if the file does not exist or has the wrong size; the
+ *              region is then left erased.
+ */
+bool host_flash_load(const char *path)
+{
+   FILE *f = fopen(path, "rb");
+   bool ok;
+
+   host_flash_init();
+   if (f == NULL)
+   {
+      return false;
+   }
+   ok = fread(region, 1, sizeof(region), f) == sizeof(region);
+   fclose(f);
+   if (!ok)
+   {
+      memset(region, 0xFF, sizeof(region));
+   }
+   return ok;
+}
+
+/**
+ * @brief Writes the DATALOG region to a file.
+ */
+bool host_flash_save(const char *path)
+{
+   FILE *f = fopen(path, "wb");
+   bool ok;
+
+   if (f == NULL)
+   {
+      return false;
+   }
+   host_flash_init();
+   ok = fwrite(region, 1, sizeof(region), f) == sizeof(region);
+   fclose(f);
+   return ok;
+}
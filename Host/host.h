@@ -0,0 +1,29 @@
+#ifndef __HOST_H__
+#define __HOST_H__
+
+/**
+ * @file    host.h
+ * @brief   Simulation hooks of the host (Linux) peripheral backend.
+ *
+ * The firmware modules in Src/ only talk to hardware through the driver
+ * interfaces i2c.h, spi.h, pwm.h, timer.h, systick.h and switch.h. On the
+ * board those are implemented by the register-level drivers in Src/; in the
+ * host build they are implemented by the *_host.c files in this directory.
+ * The functions below let the simulation advance time and inject events,
+ * standing in for the interrupts the hardware would raise.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+void host_systick_advance(void);
+void host_tim7_advance(uint32_t ms);
+void host_switch_press(void);
+uint8_t host_led_brightness(void);
+bool host_flash_load(const char *path);
+bool host_flash_save(const char *path);
+
+#endif
@@ -0,0 +1,417 @@
+/**
+ * @file    i2c_check.c
+ * @brief   Check of the interrupt-driven I2C1 driver against a fake register
+ *          block.
+ *
+ * Src/i2c.c is compiled into this program unchanged. Before it is included,
+ * I2C1, RCC and GPIOB are redirected to structures in RAM, and the PRIMASK,
+ * WFI and NVIC intrinsics to stubs, so the driver runs on the host. Each step
+ * of a transfer sets the ISR flags the peripheral would raise and calls
+ * I2C1_IRQHandler(); the check then looks at what the driver wrote to CR2,
+ * TXDR and ICR and at the transfer descriptors. Covered are:
+ *  - a register read: TXIS, TC and the repeated START, RXNE, STOPF,
+ *  - a register write with AUTOEND,
+ *  - an address NACK, reported after the automatic STOP,
+ *  - a bus error and the SCL low timeout, with the peripheral reset,
+ *  - the I2C_Poll() timeout, also through the blocking I2C_ReadReg(),
+ *  - I2C_Wait() sleeping with interrupts masked until the transfer is done,
+ *  - lengths beyond a single NBYTES count, rejected without queuing,
+ *  - a full queue, completion order and the wrap of the queue indexes,
+ *  - an interrupt with no transfer active.
+ *
+ * The program prints every failed expectation and exits with status 1 if
+ * there was one.
+ *
+ * Usage: i2c_check
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+// Rename the Cortex-M0 intrinsics so that their inline assembly is never used
+#define __disable_irq cmsis_disable_irq
+#define __get_PRIMASK cmsis_get_PRIMASK
+#define __set_PRIMASK cmsis_set_PRIMASK
+#include <stm32f091xc.h>
+#undef __disable_irq
+#undef __get_PRIMASK
+#undef __set_PRIMASK
+#undef __WFI
+#undef NVIC_SetPriority
+#undef NVIC_ClearPendingIRQ
+#undef NVIC_EnableIRQ
+#undef I2C1
+#undef RCC
+#undef GPIOB
+
+static I2C_TypeDef fake_i2c1;
+static RCC_TypeDef fake_rcc;
+static GPIO_TypeDef fake_gpiob;
+static uint32_t primask;
+static uint32_t now_us;
+static uint32_t us_per_read;   // Fake clock advance per get_time_us() call
+static uint32_t sleeps;
+static uint32_t sleeps_unmasked;
+static void (*wake_hook)(void);  // Interrupt that ends the next sleep, or NULL
+
+/**
+ * @brief Stands in for WFI: records the sleep and delivers the interrupt
+ *        that wakes the core, if there is one.
+ */
+static void fake_wfi(void)
+{
+   void (*hook)(void) = wake_hook;
+
+   sleeps++;
+   sleeps_unmasked += (primask == 0);
+   wake_hook = NULL;
+   if (hook != NULL)
+   {
+      hook();
+   }
+}
+
+#define I2C1  (&fake_i2c1)
+#define RCC   (&fake_rcc)
+#define GPIOB (&fake_gpiob)
+
+#define __disable_irq()       (primask = 1)
+#define __get_PRIMASK()       (primask)
+#define __set_PRIMASK(mask)   (primask = (mask))
+#define __WFI()               fake_wfi()
+#define NVIC_SetPriority(irq, priority) ((void)(irq), (void)(priority))
+#define NVIC_ClearPendingIRQ(irq)       ((void)(irq))
+#define NVIC_EnableIRQ(irq)             ((void)(irq))
+
+#include "../Src/i2c.c"
+
+#define SENSOR_ADDR  0x76
+#define CR2_ADDR     (SENSOR_ADDR << 1)
+
+static unsigned failures;
+static uint32_t callbacks;
+
+#define EXPECT(cond) expect((cond), #cond, __LINE__)
+
+static void expect(bool ok, const char *what, int line)
+{
+   if (!ok)
+   {
+      printf("FAIL line %d: %s\n", line, what);
+      failures++;
+   }
+}
+
+uint32_t get_time_us(void)
+{
+   now_us += us_per_read;
+   return now_us;
+}
+
+static void count_callback(I2C_Transfer *xfer)
+{
+   (void)xfer;
+   callbacks++;
+}
+
+/**
+ * @brief Raises the given ISR flags and runs the interrupt handler once.
+ *
+ * The handler clears what it handles through ICR; the fake peripheral drops
+ * all flags afterwards, as the next event sets its own.
+ */
+static void raise(uint32_t isr)
+{
+   fake_i2c1.ISR = isr;
+   fake_i2c1.ICR = 0;
+   I2C1_IRQHandler();
+   fake_i2c1.ISR = 0;
+}
+
+static uint32_t cr2_field(uint32_t mask, uint32_t pos)
+{
+   return (fake_i2c1.CR2 & mask) >> pos;
+}
+
+static void reset_driver(void)
+{
+   memset(&fake_i2c1, 0, sizeof(fake_i2c1));
+   us_per_read = 0;
+   callbacks = 0;
+   sleeps = 0;
+   sleeps_unmasked = 0;
+   wake_hook = NULL;
+   I2C_Init();
+}
+
+static I2C_Transfer make_read(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+   return (I2C_Transfer){ .dev_adx = SENSOR_ADDR, .reg_adx = reg, .bufp = buf, .data_len = len,
+                          .read = true, .callback = count_callback };
+}
+
+/**
+ * @brief Clocks a read transfer through every interrupt up to STOP.
+ */
+static void complete_read(const uint8_t *data, uint16_t len)
+{
+   raise(I2C_ISR_TXIS);
+   raise(I2C_ISR_TC);
+   for (uint16_t i = 0; i < len; i++)
+   {
+      fake_i2c1.RXDR = data[i];
+      raise(I2C_ISR_RXNE);
+   }
+   raise(I2C_ISR_STOPF);
+}
+
+static void check_read(void)
+{
+   const uint8_t data[3] = { 0x65, 0x43, 0x21 };
+   uint8_t buf[3] = { 0 };
+   I2C_Transfer xfer = make_read(0xF7, buf, sizeof(buf));
+
+   reset_driver();
+   EXPECT(fake_i2c1.CR1 & I2C_CR1_PE);
+   EXPECT(I2C_Submit(&xfer) == I2C_OK);
+   EXPECT(!xfer.done && (xfer.status == I2C_BUSY));
+   EXPECT(cr2_field(I2C_CR2_SADD_Msk, I2C_CR2_SADD_Pos) == CR2_ADDR);
+   EXPECT(cr2_field(I2C_CR2_NBYTES_Msk, I2C_CR2_NBYTES_Pos) == 1);
+   EXPECT(!(fake_i2c1.CR2 & (I2C_CR2_RD_WRN | I2C_CR2_AUTOEND)));
+   EXPECT(fake_i2c1.CR2 & I2C_CR2_START);
+
+   raise(I2C_ISR_TXIS);
+   EXPECT(fake_i2c1.TXDR == 0xF7);
+
+   fake_i2c1.CR2 &= ~I2C_CR2_START;   // Cleared by hardware once sent
+   raise(I2C_ISR_TC);
+   EXPECT(fake_i2c1.CR2 & I2C_CR2_RD_WRN);
+   EXPECT(fake_i2c1.CR2 & I2C_CR2_AUTOEND);
+   EXPECT(fake_i2c1.CR2 & I2C_CR2_START);
+   EXPECT(cr2_field(I2C_CR2_NBYTES_Msk, I2C_CR2_NBYTES_Pos) == sizeof(data));
+   EXPECT(cr2_field(I2C_CR2_SADD_Msk, I2C_CR2_SADD_Pos) == CR2_ADDR);
+
+   for (uint16_t i = 0; i < sizeof(data); i++)
+   {
+      fake_i2c1.RXDR = data[i];
+      raise(I2C_ISR_RXNE);
+   }
+   EXPECT(!xfer.done);
+
+   raise(I2C_ISR_STOPF);
+   EXPECT(fake_i2c1.ICR & I2C_ICR_STOPCF);
+   EXPECT(xfer.done && (xfer.status == I2C_OK));
+   EXPECT(memcmp(buf, data, sizeof(data)) == 0);
+   EXPECT(callbacks == 1);
+   EXPECT(I2C_Is_Idle());
+}
+
+static void check_write(void)
+{
+   uint8_t data[2] = { 0x27, 0xA0 };
+   I2C_Transfer xfer = { .dev_adx = SENSOR_ADDR, .reg_adx = 0xF4, .bufp = data, .data_len = 2,
+                         .read = false };
+
+   reset_driver();
+   EXPECT(I2C_Submit(&xfer) == I2C_OK);
+   EXPECT(cr2_field(I2C_CR2_NBYTES_Msk, I2C_CR2_NBYTES_Pos) == 3);
+   EXPECT(fake_i2c1.CR2 & I2C_CR2_AUTOEND);
+   EXPECT(!(fake_i2c1.CR2 & I2C_CR2_RD_WRN));
+
+   raise(I2C_ISR_TXIS);
+   EXPECT(fake_i2c1.TXDR == 0xF4);
+   raise(I2C_ISR_TXIS);
+   EXPECT(fake_i2c1.TXDR == 0x27);
+   raise(I2C_ISR_TXIS);
+   EXPECT(fake_i2c1.TXDR == 0xA0);
+   raise(I2C_ISR_STOPF);
+   EXPECT(xfer.done && (xfer.status == I2C_OK));
+}
+
+static void check_nack(void)
+{
+   uint8_t buf[1];
+   I2C_Transfer xfer = make_read(0xD0, buf, 1);
+
+   reset_driver();
+   I2C_Submit(&xfer);
+   raise(I2C_ISR_NACKF);
+   EXPECT(fake_i2c1.ICR & I2C_ICR_NACKCF);
+   EXPECT(!xfer.done);   // Waits for the automatic STOP
+   raise(I2C_ISR_STOPF);
+   EXPECT(xfer.done && (xfer.status == I2C_NACK));
+   EXPECT(I2C_Is_Idle());
+}
+
+static void check_errors(void)
+{
+   uint8_t buf[1];
+   I2C_Transfer bus_error = make_read(0xD0, buf, 1);
+   I2C_Transfer scl_timeout = make_read(0xD0, buf, 1);
+
+   reset_driver();
+   I2C_Submit(&bus_error);
+   I2C_Submit(&scl_timeout);
+   raise(I2C_ISR_TXIS);
+   raise(I2C_ISR_BERR);
+   EXPECT(bus_error.done && (bus_error.status == I2C_BUS_ERROR));
+   EXPECT(fake_i2c1.ICR & I2C_ICR_BERRCF);
+   EXPECT(fake_i2c1.CR1 & I2C_CR1_PE);   // Re-enabled after the reset
+
+   // The next transfer starts from the error path
+   EXPECT(!scl_timeout.done);
+   raise(I2C_ISR_TIMEOUT);
+   EXPECT(scl_timeout.done && (scl_timeout.status == I2C_TIMEOUT));
+   EXPECT(I2C_Is_Idle());
+}
+
+static void check_poll_timeout(void)
+{
+   uint8_t buf[1];
+   I2C_Transfer xfer = make_read(0xD0, buf, 1);
+
+   reset_driver();
+   I2C_Submit(&xfer);
+   I2C_Poll();                         // First sight of the transfer
+   now_us += I2C_TIMEOUT_US;
+   I2C_Poll();
+   EXPECT(!xfer.done);
+   now_us += 1;
+   I2C_Poll();
+   EXPECT(xfer.done && (xfer.status == I2C_TIMEOUT));
+   EXPECT(I2C_Is_Idle());
+   EXPECT(primask == 0);
+
+   // No interrupt ever comes: the blocking read gives up on its own
+   us_per_read = 1000;
+   EXPECT(I2C_ReadReg(SENSOR_ADDR, 0xD0, buf, 1) == I2C_TIMEOUT);
+   EXPECT(sleeps > 0);
+   EXPECT(sleeps_unmasked == 0);
+   EXPECT(primask == 0);
+}
+
+static void complete_one_byte(void)
+{
+   const uint8_t data = 0x60;
+
+   complete_read(&data, 1);
+}
+
+static void check_wait(void)
+{
+   uint8_t buf[1] = { 0 };
+   I2C_Transfer xfer = make_read(0xD0, buf, 1);
+
+   // The STOP interrupt ends the only sleep
+   reset_driver();
+   EXPECT(I2C_Submit(&xfer) == I2C_OK);
+   wake_hook = complete_one_byte;
+   EXPECT(I2C_Wait(&xfer) == I2C_OK);
+   EXPECT((sleeps == 1) && (sleeps_unmasked == 0));
+   EXPECT(buf[0] == 0x60);
+   EXPECT(primask == 0);
+
+   // A finished transfer does not sleep at all
+   EXPECT(I2C_Wait(&xfer) == I2C_OK);
+   EXPECT(sleeps == 1);
+}
+
+static void check_lengths(void)
+{
+   static uint8_t buf[I2C_MAX_READ_LEN + 1];
+   I2C_Transfer xfer = make_read(0x88, buf, 0);
+
+   reset_driver();
+   EXPECT(I2C_Submit(&xfer) == I2C_INVALID);
+   xfer.data_len = I2C_MAX_READ_LEN + 1;
+   EXPECT(I2C_Submit(&xfer) == I2C_INVALID);
+   xfer.read = false;
+   xfer.data_len = I2C_MAX_WRITE_LEN + 1;
+   EXPECT(I2C_Submit(&xfer) == I2C_INVALID);
+   EXPECT(I2C_Is_Idle() && (fake_i2c1.CR2 == 0));
+   EXPECT(primask == 0);
+   EXPECT(I2C_WriteReg(SENSOR_ADDR, 0xF4, buf, I2C_MAX_WRITE_LEN + 1) == I2C_INVALID);
+   EXPECT(sleeps == 0);
+
+   // The longest transfers still fit into NBYTES
+   xfer.data_len = I2C_MAX_WRITE_LEN;
+   EXPECT(I2C_Submit(&xfer) == I2C_OK);
+   EXPECT(cr2_field(I2C_CR2_NBYTES_Msk, I2C_CR2_NBYTES_Pos) == I2C_MAX_WRITE_LEN + 1);
+
+   reset_driver();
+   xfer.read = true;
+   xfer.data_len = I2C_MAX_READ_LEN;
+   EXPECT(I2C_Submit(&xfer) == I2C_OK);
+   raise(I2C_ISR_TXIS);
+   raise(I2C_ISR_TC);
+   EXPECT(cr2_field(I2C_CR2_NBYTES_Msk, I2C_CR2_NBYTES_Pos) == I2C_MAX_READ_LEN);
+}
+
+static void check_queue(void)
+{
+   uint8_t buf[I2C_QUEUE_SIZE * 2][1];
+   I2C_Transfer xfer[I2C_QUEUE_SIZE * 2];
+   I2C_Transfer extra = make_read(0x00, buf[0], 1);
+   const uint8_t data = 0x60;
+
+   reset_driver();
+   for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++)
+   {
+      xfer[i] = make_read(i, buf[i], 1);
+      EXPECT(I2C_Submit(&xfer[i]) == I2C_OK);
+   }
+   EXPECT(I2C_Submit(&extra) == I2C_BUSY);
+
+   // Complete half, refill so that the indexes wrap, then drain in order
+   for (uint8_t i = 0; i < I2C_QUEUE_SIZE / 2; i++)
+   {
+      complete_read(&data, 1);
+      EXPECT(xfer[i].done && (xfer[i].status == I2C_OK));
+      EXPECT(!xfer[i + 1].done);
+   }
+   for (uint8_t i = I2C_QUEUE_SIZE; i < I2C_QUEUE_SIZE + I2C_QUEUE_SIZE / 2; i++)
+   {
+      xfer[i] = make_read(i, buf[i], 1);
+      EXPECT(I2C_Submit(&xfer[i]) == I2C_OK);
+   }
+   EXPECT(I2C_Submit(&extra) == I2C_BUSY);
+   for (uint8_t i = I2C_QUEUE_SIZE / 2; i < I2C_QUEUE_SIZE + I2C_QUEUE_SIZE / 2; i++)
+   {
+      raise(I2C_ISR_TXIS);
+      EXPECT(fake_i2c1.TXDR == i);   // Register address of transfer i
+      raise(I2C_ISR_TC);
+      fake_i2c1.RXDR = data;
+      raise(I2C_ISR_RXNE);
+      raise(I2C_ISR_STOPF);
+      EXPECT(xfer[i].done && (xfer[i].status == I2C_OK) && (buf[i][0] == data));
+   }
+   EXPECT(callbacks == I2C_QUEUE_SIZE + I2C_QUEUE_SIZE / 2);
+   EXPECT(I2C_Is_Idle());
+}
+
+static void check_stale_interrupt(void)
+{
+   reset_driver();
+   raise(I2C_ISR_STOPF | I2C_ISR_NACKF);
+   EXPECT(fake_i2c1.ICR == I2C_CLEAR_ALL_FLAGS);
+   EXPECT(I2C_Is_Idle());
+}
+
+int main(void)
+{
+   check_read();
+   check_write();
+   check_nack();
+   check_errors();
+   check_poll_timeout();
+   check_wait();
+   check_lengths();
+   check_queue();
+   check_stale_interrupt();
+
+   printf("i2c: %u failure%s\n", failures, (failures == 1) ? "" : "s");
+   return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file    i2c_host.c
+ * @brief   Host implementation of the I2C1 driver interface.
+ *
+ * Transfers are executed against the BME280 register models attached with
+ * bme280_model_attach(). They complete immediately inside I2C_Submit(), so
+ * the done flag and callback behave as if the interrupt had already fired.
+ * An address with no model attached is reported as I2C_NACK.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stddef.h>
+#include "i2c.h"
+#include "bme280_model.h"
+
+/**
+ * @brief Nothing to configure on the host.
+ */
+void I2C_Init(void)
+{
+}
+
+/**
+ * @brief Executes a transfer against the simulated bus.
+ *
+ * @param[in,out] xfer Transfer descriptor.
+ * @return I2C_OK, the transfer has already completed, or I2C_INVALID for a
+ *         length the peripheral driver rejects.
+ */
+I2C_Status I2C_Submit(I2C_Transfer *xfer)
+{
+   BME280_Model *model = bme280_model_find(xfer->dev_adx);
+   uint16_t max_len = xfer->read ? I2C_MAX_READ_LEN : I2C_MAX_WRITE_LEN;
+   I2C_Status status = I2C_OK;
+
+   if ((xfer->data_len == 0) || (xfer->data_len > max_len))
+   {
+      return I2C_INVALID;
+   }
+   if (model == NULL)
+   {
+      status = I2C_NACK;
+   }
+   else
+   {
+      for (uint16_t i = 0; i < xfer->data_len; i++)
+      {
+         uint8_t reg = xfer->reg_adx + i;
+         if (xfer->read)
+         {
+            xfer->bufp[i] = bme280_model_read(model, reg);
+         }
+         else
+         {
+            bme280_model_write(model, reg, xfer->bufp[i]);
+         }
+      }
+   }
+
+   xfer->status = status;
+   xfer->done = true;
+   if (xfer->callback != NULL)
+   {
+      xfer->callback(xfer);
+   }
+   return I2C_OK;
+}
+
+I2C_Status I2C_Wait(I2C_Transfer *xfer)
+{
+   return xfer->status;
+}
+
+void I2C_Poll(void)
+{
+}
+
+bool I2C_Is_Idle(void)
+{
+   return true;
+}
+
+I2C_Status I2C_ReadReg(uint8_t dev_adx, uint8_t reg_adx, uint8_t *bufp, uint16_t data_len)
+{
+   I2C_Transfer xfer = {
+      .dev_adx = dev_adx,
+      .reg_adx = reg_adx,
+      .bufp = bufp,
+      .data_len = data_len,
+      .read = true,
+      .callback = NULL
+   };
+
+   I2C_Submit(&xfer);
+   return I2C_Wait(&xfer);
+}
+
+I2C_Status I2C_WriteReg(uint8_t dev_adx, uint8_t reg_adx, const uint8_t *bufp, uint16_t data_len)
+{
+   I2C_Transfer xfer = {
+      .dev_adx = dev_adx,
+      .reg_adx = reg_adx,
+      .bufp = (uint8_t *)bufp,
+      .data_len = data_len,
+      .read = false,
+      .callback = NULL
+   };
+
+   I2C_Submit(&xfer);
+   return I2C_Wait(&xfer);
+}
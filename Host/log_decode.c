@@ -0,0 +1,100 @@
+/**
+ * @file    log_decode.c
+ * @brief   Decoder of the deferred log stream (Src/log.h, LOG_DEFERRED).
+ *
+ * Reads a capture of the console UART, or the output of
+ * weather_station_host built with LOG_DEFERRED=1, finds the log frames by
+ * their sync bytes and CRC and prints each as one line of text, rebuilt
+ * from the message table of Src/log_messages.h, or, for a text frame, with
+ * the text it carries. Any other output is copied through unchanged.
+ *
+ * Usage: log_decode [capture]     (standard input by default)
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "log.h"
+
+static const char *const kind_names[LOG_KIND_COUNT] = { "INFO", "WARNING", "USER", "STATE" };
+
+int main(int argc, char *argv[])
+{
+   FILE *in = stdin;
+   uint8_t window[LOG_TEXT_FRAME_MAX_SIZE];
+   size_t fill = 0;
+   unsigned long frames = 0;
+   bool eof = false;
+
+   if (argc > 1)
+   {
+      in = fopen(argv[1], "rb");
+      if (in == NULL)
+      {
+         perror(argv[1]);
+         return 1;
+      }
+   }
+
+   while (!eof || (fill > 0))
+   {
+      LogFrame frame;
+      char text[256];
+      LogKind kind;
+      int length;
+
+      if (!eof && (fill < sizeof(window)))
+      {
+         int c = fgetc(in);
+         if (c == EOF)
+         {
+            eof = true;
+         }
+         else
+         {
+            window[fill++] = (uint8_t)c;
+         }
+      }
+
+      if (fill == 0)
+      {
+         continue;
+      }
+      length = log_frame_decode(window, fill, &frame, text);
+      if ((length == 0) && !eof)
+      {
+         continue;   // Too short to tell yet
+      }
+      if (length <= 0)
+      {
+         // Not a frame here: pass one byte through and slide
+         putchar(window[0]);
+         memmove(window, window + 1, --fill);
+         continue;
+      }
+      memmove(window, window + length, fill - (size_t)length);
+      fill -= (size_t)length;
+      frames++;
+
+      if (frame.id >= LOG_FRAME_TEXT)
+      {
+         kind = (LogKind)(frame.id - LOG_FRAME_TEXT);
+      }
+      else
+      {
+         kind = log_message_kind(frame.id);
+         log_format(frame.id, frame.nargs, frame.args, text, sizeof(text));
+      }
+      printf("\n[%10.3f] %-7s %s\n", frame.time_ms / 1000.0, kind_names[kind], text);
+   }
+
+   fprintf(stderr, "%lu log frames decoded\n", frames);
+   if (in != stdin)
+   {
+      fclose(in);
+   }
+   return 0;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file    main_host.c
+ * @brief   Entry point of the host (Linux) build of the weather station.
+ *
+ * Initializes the firmware exactly like Src/main.c, then replaces
+ * run_scheduler() by a simulation loop: every simulated second the
+ * environment seen by the BME280 model is updated, TIM7, the switch and
+ * SysTick raise their (simulated) interrupts and scheduler_dispatch() runs
+ * the tasks they posted. Task run times are measured in host CPU time. Simulated time is decoupled from wall time,
+ * so days of operation run in seconds and the hot path can be profiled with
+ * perf or callgrind.
+ *
+ * Usage: weather_station_host [-t seconds] [-p press_interval] [-q] [-f flash_image] [-l level]
+ *                             [-P profile]
+ *   -t  simulated duration in seconds (default 86400)
+ *   -p  press switch B1 every press_interval seconds (default 0, never)
+ *   -q  suppress firmware console output, print only the summary
+ *   -f  load the DATALOG flash region from flash_image and save it back at
+ *       the end, so the log survives from one run to the next
+ *   -l  run-time log level, LOG_LEVEL_NONE (0) to LOG_LEVEL_INFO (4)
+ *   -P  switch the sensors to entry profile of bme280_profiles[] after
+ *       start-up, through set_acquisition_profile()
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+#include "spi.h"
+#include "i2c.h"
+#include "bme280.h"
+#include "switch.h"
+#include "fsm.h"
+#include "data_acquisition.h"
+#include "systick.h"
+#include "pwm.h"
+#include "log.h"
+#include "timer.h"
+#include "scheduler.h"
+#include "power.h"
+#include "flash_log.h"
+#include "profiler.h"
+#include "uart.h"
+#include "host.h"
+#include "bme280_model.h"
+
+#ifdef RUN_WITH_SPI
+#define SENSOR_ADDR      SPI_CS_DEFAULT
+#else
+#define SENSOR_ADDR      BME280_I2C_ADDR_PRIMARY
+#endif
+#define SECONDS_PER_DAY  86400.0
+#define TICK_MS          1000
+
+extern FSMInfo info;
+
+/**
+ * @brief Sets the simulated weather for second t.
+ *
+ * Temperature follows a daily cycle between 18.5 and 24.5 °C so the
+ * EMERGENCY threshold is crossed every afternoon; pressure and humidity
+ * drift slowly.
+ */
+static void update_environment(BME280_Model *sensor, uint32_t t)
+{
+   double day = 2.0 * M_PI * t / SECONDS_PER_DAY;
+
+   bme280_model_set_environment(sensor,
+                                21.5 + 3.0 * sin(day),
+                                101325.0 + 300.0 * sin(day / 3.0),
+                                45.0 - 10.0 * sin(day));
+}
+
+int main(int argc, char *argv[])
+{
+   uint32_t duration = (uint32_t)SECONDS_PER_DAY;
+   uint32_t press_interval = 0;
+   uint32_t state_seconds[3] = {0};
+   const char *flash_file = NULL;
+   long profile = -1;
+   int opt;
+
+   while ((opt = getopt(argc, argv, "t:p:qf:l:P:")) != -1)
+   {
+      switch (opt)
+      {
+      case 't':
+         duration = strtoul(optarg, NULL, 0);
+         break;
+      case 'p':
+         press_interval = strtoul(optarg, NULL, 0);
+         break;
+      case 'f':
+         flash_file = optarg;
+         break;
+      case 'l':
+         log_set_level((uint8_t)strtoul(optarg, NULL, 0));
+         break;
+      case 'P':
+         profile = strtol(optarg, NULL, 0);
+         break;
+      case 'q':
+         if (freopen("/dev/null", "w", stdout) == NULL)
+         {
+            perror("freopen");
+         }
+         break;
+      default:
+         fprintf(stderr, "usage: %s [-t seconds] [-p press_interval] [-q] [-f flash_image] [-l level] [-P profile]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   if ((flash_file != NULL) && !host_flash_load(flash_file))
+   {
+      fprintf(stderr, "%s not loaded, starting with erased flash\n", flash_file);
+   }
+
+   BME280_Model *sensor = bme280_model_attach(SENSOR_ADDR, NULL);
+   update_environment(sensor, 0);
+#ifdef SECOND_SENSOR
+   BME280_Model *sensor2 = bme280_model_attach(BME280_I2C_ADDR_SECONDARY, NULL);
+   update_environment(sensor2, 0);
+#endif
+
+   Init_UART_TX();
+   init_systick();
+#ifdef RUN_WITH_SPI
+   Init_SPI2();
+#else
+   I2C_Init();
+#endif
+   PWM_Init();
+   Init_switch();
+   if (Init_DataAcquisition() != get_sensor_count())
+   {
+      fprintf(stderr, "BME280_Init failed\n");
+      return 1;
+   }
+   if ((profile >= 0) && !set_acquisition_profile((BME280_Profile)profile))
+   {
+      fprintf(stderr, "unknown profile %ld\n", profile);
+      return 1;
+   }
+   Init_Scheduler();
+   Init_FlashLog();
+   Init_FSM();
+   Init_Log();
+   Init_Power(POWER_MODE_RUN);
+   Init_Profiler();
+   Init_TIM7();
+   STATE_TRANSITION_LOG("NORMAL state");
+
+   for (uint32_t t = 1; t <= duration; t++)
+   {
+      update_environment(sensor, t);
+#ifdef SECOND_SENSOR
+      update_environment(sensor2, t + 3600);
+#endif
+      host_tim7_advance(TICK_MS);
+      if ((press_interval != 0) && ((t % press_interval) == 0))
+      {
+         host_switch_press();
+      }
+      scheduler_dispatch();
+      state_seconds[info.state]++;
+      host_systick_advance();
+      scheduler_dispatch();
+   }
+
+   if ((flash_file != NULL) && !host_flash_save(flash_file))
+   {
+      perror(flash_file);
+   }
+
+   fflush(stdout);
+   fprintf(stderr, "\nsimulated %u s: NORMAL %u s, EMERGENCY %u s, USER %u s\n",
+           duration, state_seconds[NORMAL], state_seconds[EMERGENCY], state_seconds[USER]);
+   for (uint8_t i = 0; scheduler_get_task(i) != NULL; i++)
+   {
+      const SchedulerTask *task = scheduler_get_task(i);
+      fprintf(stderr, "  task %-8s runs %8u total %10llu us max %6u us\n", task->name,
+              task->runs, (unsigned long long)task->run_time_us, task->max_time_us);
+   }
+   return 0;
+}
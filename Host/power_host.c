@@ -0,0 +1,46 @@
+/**
+ * @file    power_host.c
+ * @brief   Host implementation of the power management interface.
+ *
+ * The simulation has no low-power states: the tick is always driven by
+ * host_systick_advance() and the core never idles, so all time is
+ * accounted as RUN.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include "power.h"
+
+static PowerMode power_mode = POWER_MODE_RUN;
+
+void Init_Power(PowerMode mode)
+{
+   power_mode = mode;
+}
+
+PowerMode power_get_mode(void)
+{
+   return power_mode;
+}
+
+void power_allow_stop(bool allow)
+{
+   (void)allow;
+}
+
+void power_idle(void)
+{
+}
+
+void power_get_times(uint64_t times_us[POWER_STATE_COUNT])
+{
+   for (uint8_t i = 0; i < POWER_STATE_COUNT; i++)
+   {
+      times_us[i] = 0;
+   }
+}
+
+void power_report(void)
+{
+}
@@ -0,0 +1,30 @@
+/**
+ * @file    pwm_host.c
+ * @brief   Host implementation of the PWM LED interface.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include "pwm.h"
+#include "host.h"
+
+uint8_t current_brightness_level = MAXIMUM_LED_BRIGHTNESS;
+
+void PWM_Init(void)
+{
+}
+
+void led_brightness(uint8_t brightness_level)
+{
+   current_brightness_level = brightness_level;
+}
+
+/**
+ * @brief Returns the last brightness written to the LED.
+ */
+uint8_t host_led_brightness(void)
+{
+   return current_brightness_level;
+}
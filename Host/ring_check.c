@@ -0,0 +1,375 @@
+/**
+ * @file    ring_check.c
+ * @brief   Check of the ring buffer of buffer.c against a plain FIFO model.
+ *
+ * Elements are sequence numbers, so the model is just the next number to
+ * push and the next number to pop. Each check starts the ring at every
+ * index from 0 to 2 x capacity - 1, so transfers run across the end of the
+ * storage and across the wrap of the indexes. Covered are:
+ *  - the empty and full boundaries: single and bulk operations that are
+ *    refused or clipped, ring_peek() past the fill level, ring_discard(),
+ *  - the indexes wrapping many times past 2 x capacity at every fill level,
+ *  - ring_push_bulk() and ring_pop_bulk() split around the end of the storage,
+ *  - ring_spans() and ring_window() at the split point, clipping and starts
+ *    beyond the fill level,
+ *  - random operation sequences, with odd capacities and the maximum one.
+ *
+ * The program prints every failed expectation and exits with status 1 if
+ * there was one.
+ *
+ * Usage: ring_check [-n operations] [-s seed]
+ *   -n  operations per random sequence (default 100000)
+ *   -s  random seed (default 1)
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "buffer.h"
+
+#define SUCCESS 1
+#define ERROR   -1
+
+static unsigned failures;
+static uint32_t rng_state;
+
+#define EXPECT(cond) expect((cond), #cond, __LINE__)
+
+static void expect(bool ok, const char *what, int line)
+{
+   if (!ok)
+   {
+      printf("FAIL line %d: %s\n", line, what);
+      failures++;
+   }
+}
+
+static uint32_t rng_next(void)
+{
+   // xorshift32
+   rng_state ^= rng_state << 13;
+   rng_state ^= rng_state >> 17;
+   rng_state ^= rng_state << 5;
+   return rng_state;
+}
+
+/**
+ * @brief A ring of uint32_t and the sequence numbers it should hold.
+ */
+typedef struct
+{
+   RingBuffer ring;
+   uint32_t next_in;          // Number the next push stores
+   uint32_t next_out;         // Number the next pop returns
+} Fixture;
+
+/**
+ * @brief Creates an empty ring whose head and tail both sit at index start.
+ */
+static Fixture make_fixture(uint32_t *storage, uint16_t capacity, uint16_t start)
+{
+   Fixture f = { { (uint8_t *)storage, sizeof(uint32_t), capacity, 0, 0 }, 0, 0 };
+   uint32_t value;
+
+   for (uint16_t i = 0; i < start; i++)
+   {
+      ring_push(&f.ring, &f.next_in);
+      ring_pop(&f.ring, &value);
+      f.next_in++;
+   }
+   f.next_out = f.next_in;
+   return f;
+}
+
+static uint16_t model_length(const Fixture *f)
+{
+   return (uint16_t)(f->next_in - f->next_out);
+}
+
+/**
+ * @brief Checks the fill level and the index range against the model.
+ */
+static void check_state(const Fixture *f)
+{
+   uint16_t length = model_length(f);
+
+   EXPECT(f->ring.head < 2U * f->ring.capacity);
+   EXPECT(f->ring.tail < 2U * f->ring.capacity);
+   EXPECT(ring_length(&f->ring) == length);
+   EXPECT(ring_space(&f->ring) == f->ring.capacity - length);
+   EXPECT(ring_is_empty(&f->ring) == (length == 0));
+   EXPECT(ring_is_full(&f->ring) == (length == f->ring.capacity));
+}
+
+static uint16_t push_many(Fixture *f, uint16_t count)
+{
+   uint32_t values[count + 1];
+   uint16_t pushed;
+
+   for (uint16_t i = 0; i < count; i++)
+   {
+      values[i] = f->next_in + i;
+   }
+   pushed = ring_push_bulk(&f->ring, values, count);
+   f->next_in += pushed;
+   return pushed;
+}
+
+static uint16_t pop_many(Fixture *f, uint16_t count)
+{
+   uint32_t values[count + 1];
+   uint16_t popped = ring_pop_bulk(&f->ring, values, count);
+
+   for (uint16_t i = 0; i < popped; i++)
+   {
+      EXPECT(values[i] == f->next_out + i);
+   }
+   f->next_out += popped;
+   return popped;
+}
+
+/**
+ * @brief Checks that the spans of [start, start + count) hold the right
+ *        elements and split exactly at the end of the storage.
+ */
+static void check_spans(const Fixture *f, uint16_t start, uint16_t count)
+{
+   RingSpan spans[2];
+   uint16_t length = model_length(f);
+   uint16_t expected = (start >= length) ? 0 : ((count > length - start) ? length - start : count);
+   uint16_t slot = (uint16_t)((f->ring.tail + start) % f->ring.capacity);
+   uint8_t used = ring_spans(&f->ring, start, count, spans);
+   uint32_t value = f->next_out + start;
+
+   if (expected == 0)
+   {
+      EXPECT(used == 0);
+   }
+   else if (slot + expected <= f->ring.capacity)
+   {
+      EXPECT(used == 1);
+      EXPECT(spans[0].data == f->ring.storage + slot * sizeof(uint32_t));
+   }
+   else
+   {
+      EXPECT(used == 2);
+      EXPECT(spans[0].count == f->ring.capacity - slot);
+      EXPECT(spans[1].data == f->ring.storage);
+   }
+   EXPECT(spans[0].count + spans[1].count == expected);
+   for (uint8_t s = 0; s < 2; s++)
+   {
+      const uint32_t *data = spans[s].data;
+
+      EXPECT((s < used) || ((spans[s].count == 0) && (data == NULL)));
+      for (uint16_t i = 0; i < spans[s].count; i++)
+      {
+         EXPECT(data[i] == value++);
+      }
+   }
+}
+
+static void check_boundaries(uint32_t *storage, uint16_t capacity)
+{
+   for (uint16_t start = 0; start < 2 * capacity; start++)
+   {
+      Fixture f = make_fixture(storage, capacity, start);
+      uint32_t value = 0xDEADBEEF;
+      RingSpan spans[2];
+
+      // Empty: everything that takes an element is refused
+      check_state(&f);
+      EXPECT(ring_pop(&f.ring, &value) == ERROR);
+      EXPECT(value == 0xDEADBEEF);
+      EXPECT(ring_peek(&f.ring, 0, &value) == ERROR);
+      EXPECT(pop_many(&f, capacity) == 0);
+      EXPECT(ring_discard(&f.ring, 1) == 0);
+      EXPECT(ring_window(&f.ring, spans) == 0);
+      EXPECT((spans[0].count == 0) && (spans[1].count == 0));
+
+      // Fill one at a time up to the last slot
+      for (uint16_t i = 0; i < capacity; i++)
+      {
+         EXPECT(ring_push(&f.ring, &f.next_in) == SUCCESS);
+         f.next_in++;
+      }
+      check_state(&f);
+      EXPECT(ring_push(&f.ring, &f.next_in) == ERROR);
+      EXPECT(push_many(&f, 1) == 0);
+      check_state(&f);
+
+      // Full: peek reaches the newest element, and no further
+      EXPECT((ring_peek(&f.ring, capacity - 1, &value) == SUCCESS) && (value == f.next_in - 1));
+      EXPECT(ring_peek(&f.ring, capacity, &value) == ERROR);
+      check_spans(&f, 0, capacity);
+
+      // Discard is clipped to the fill level
+      EXPECT(ring_discard(&f.ring, 0) == 0);
+      EXPECT(ring_discard(&f.ring, capacity / 2) == capacity / 2);
+      f.next_out += capacity / 2;
+      check_state(&f);
+      EXPECT(ring_discard(&f.ring, capacity + 1) == capacity - capacity / 2);
+      f.next_out = f.next_in;
+      check_state(&f);
+
+      // Bulk operations are clipped at both boundaries
+      EXPECT(push_many(&f, capacity + 1) == capacity);
+      check_state(&f);
+      EXPECT(pop_many(&f, capacity + 1) == capacity);
+      check_state(&f);
+   }
+}
+
+/**
+ * @brief Runs the indexes around several times at every fill level.
+ */
+static void check_index_wrap(uint32_t *storage, uint16_t capacity)
+{
+   for (uint16_t fill = 0; fill <= capacity; fill++)
+   {
+      Fixture f = make_fixture(storage, capacity, 0);
+
+      EXPECT(push_many(&f, fill) == fill);
+      for (uint32_t i = 0; i < 5U * 2 * capacity; i++)
+      {
+         uint32_t value;
+
+         if (fill == capacity)
+         {
+            EXPECT(pop_many(&f, 1) == 1);
+            EXPECT(push_many(&f, 1) == 1);
+         }
+         else
+         {
+            EXPECT(ring_push(&f.ring, &f.next_in) == SUCCESS);
+            f.next_in++;
+            EXPECT((ring_pop(&f.ring, &value) == SUCCESS) && (value == f.next_out));
+            f.next_out++;
+         }
+         check_state(&f);
+      }
+   }
+}
+
+/**
+ * @brief Bulk transfers and spans of every size from every start index.
+ */
+static void check_bulk_and_spans(uint32_t *storage, uint16_t capacity)
+{
+   for (uint16_t start = 0; start < 2 * capacity; start++)
+   {
+      for (uint16_t count = 1; count <= capacity; count++)
+      {
+         Fixture f = make_fixture(storage, capacity, start);
+         RingSpan window[2];
+         RingSpan all[2];
+
+         EXPECT(push_many(&f, count) == count);
+         check_state(&f);
+
+         // The window is the span of everything
+         EXPECT(ring_window(&f.ring, window) == ring_spans(&f.ring, 0, capacity, all));
+         EXPECT((window[0].data == all[0].data) && (window[0].count == all[0].count));
+         EXPECT((window[1].data == all[1].data) && (window[1].count == all[1].count));
+
+         for (uint16_t first = 0; first <= count; first++)
+         {
+            check_spans(&f, first, count - first);
+            check_spans(&f, first, capacity);
+            check_spans(&f, first, 1);
+         }
+         check_spans(&f, count + 1, 1);
+
+         EXPECT(pop_many(&f, count) == count);
+         check_state(&f);
+      }
+   }
+}
+
+/**
+ * @brief Random pushes, pops, peeks, spans and discards against the model.
+ */
+static void check_random(uint32_t *storage, uint16_t capacity, uint32_t operations)
+{
+   Fixture f = make_fixture(storage, capacity, (uint16_t)(rng_next() % (2U * capacity)));
+
+   for (uint32_t i = 0; i < operations; i++)
+   {
+      uint32_t r = rng_next();
+      uint16_t n = (uint16_t)((r >> 8) % (capacity + 2U));
+      uint16_t length = model_length(&f);
+      uint16_t space = capacity - length;
+      uint32_t value;
+
+      switch (r & 7)
+      {
+      case 0:
+      case 1:
+         EXPECT(push_many(&f, n) == ((n < space) ? n : space));
+         break;
+      case 2:
+      case 3:
+         EXPECT(pop_many(&f, n) == ((n < length) ? n : length));
+         break;
+      case 4:
+         EXPECT(ring_discard(&f.ring, n) == ((n < length) ? n : length));
+         f.next_out += (n < length) ? n : length;
+         break;
+      case 5:
+         if (n < length)
+         {
+            EXPECT((ring_peek(&f.ring, n, &value) == SUCCESS) && (value == f.next_out + n));
+         }
+         else
+         {
+            EXPECT(ring_peek(&f.ring, n, &value) == ERROR);
+         }
+         break;
+      default:
+         check_spans(&f, n, (uint16_t)(rng_next() % (capacity + 2U)));
+         break;
+      }
+      check_state(&f);
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   static const uint16_t capacities[] = { 1, 2, 3, 7, 16, 60 };
+   static uint32_t storage[RING_BUFFER_MAX_CAPACITY];
+   uint32_t operations = 100000;
+   int opt;
+
+   rng_state = 1;
+   while ((opt = getopt(argc, argv, "n:s:")) != -1)
+   {
+      switch (opt)
+      {
+      case 'n':
+         operations = strtoul(optarg, NULL, 0);
+         break;
+      case 's':
+         rng_state = strtoul(optarg, NULL, 0);
+         rng_state += (rng_state == 0);
+         break;
+      default:
+         fprintf(stderr, "usage: %s [-n operations] [-s seed]\n", argv[0]);
+         return 2;
+      }
+   }
+
+   for (uint8_t i = 0; i < sizeof(capacities) / sizeof(capacities[0]); i++)
+   {
+      check_boundaries(storage, capacities[i]);
+      check_index_wrap(storage, capacities[i]);
+      check_bulk_and_spans(storage, capacities[i]);
+      check_random(storage, capacities[i], operations);
+   }
+   check_random(storage, RING_BUFFER_MAX_CAPACITY, operations);
+
+   printf("ring: %u failure%s\n", failures, (failures == 1) ? "" : "s");
+   return (failures == 0) ? 0 : 1;
+}
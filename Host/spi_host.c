@@ -0,0 +1,86 @@
+/**
+ * @file    spi_host.c
+ * @brief   Host implementation of the SPI2 driver interface.
+ *
+ * The BME280 model attached at the selected chip-select pin plays the SPI
+ * slave; an unselected or absent slave reads as 0xFF. In SPI mode the
+ * BME280 uses bit 7 of the address byte as the read flag and only the lower
+ * seven bits select the register, so writes are mapped back to 0x80..0xFF.
+ * DMA bursts complete immediately.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stddef.h>
+#include "spi.h"
+#include "bme280_model.h"
+
+#define SPI_READ_BIT 0x80
+
+static uint8_t cs_pin = SPI_CS_DEFAULT;
+
+void Init_SPI2(void)
+{
+   cs_pin = SPI_CS_DEFAULT;
+}
+
+void SPI_Select(uint8_t pin)
+{
+   cs_pin = pin;
+}
+
+uint8_t SPI_Read(const uint8_t register_addr)
+{
+   uint8_t val = 0;
+
+   SPI_ReadBurst(register_addr, &val, 1);
+   return val;
+}
+
+void SPI_ReadBurst(const uint8_t register_addr, uint8_t *bufp, uint16_t data_len)
+{
+   BME280_Model *model = bme280_model_find(cs_pin);
+
+   for (uint16_t i = 0; i < data_len; i++)
+   {
+      // An absent slave leaves MISO pulled high
+      bufp[i] = (model != NULL) ? bme280_model_read(model, (register_addr | SPI_READ_BIT) + i) : 0xFF;
+   }
+}
+
+uint8_t SPI_Write(const uint8_t register_addr, const uint8_t data)
+{
+   BME280_Model *model = bme280_model_find(cs_pin);
+
+   if (model != NULL)
+   {
+      bme280_model_write(model, register_addr | SPI_READ_BIT, data);
+   }
+   return 0;
+}
+
+bool SPI_DMA_ReadBurst(const uint8_t register_addr, uint8_t *bufp, uint16_t data_len, SPI_Callback callback)
+{
+   if ((data_len == 0) || (data_len > SPI_DMA_MAX_LEN))
+   {
+      return false;
+   }
+
+   SPI_ReadBurst(register_addr, bufp, data_len);
+   if (callback != NULL)
+   {
+      callback(true);
+   }
+   return true;
+}
+
+bool SPI_DMA_Is_Busy(void)
+{
+   return false;
+}
+
+bool SPI_DMA_Wait(void)
+{
+   return true;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file    switch_host.c
+ * @brief   Host implementation of the user switch B1 interface.
+ *
+ * host_switch_press() plays the role of EXTI4_15_IRQHandler().
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include "switch.h"
+#include "host.h"
+
+bool switch_activated = false;
+static SwitchCallback switch_callback = NULL;
+
+void Init_switch()
+{
+}
+
+void switch_set_callback(SwitchCallback callback)
+{
+   switch_callback = callback;
+}
+
+bool is_switch_pressed()
+{
+   return false;
+}
+
+bool was_switch_activated()
+{
+   bool test = switch_activated;
+   switch_activated = false;
+   return test;
+}
+
+/**
+ * @brief Simulates a press of switch B1.
+ */
+void host_switch_press(void)
+{
+   switch_activated = true;
+   if (switch_callback != NULL)
+   {
+      switch_callback();
+   }
+}
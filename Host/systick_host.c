@@ -0,0 +1,81 @@
+/**
+ * @file    systick_host.c
+ * @brief   Host implementation of the SysTick timekeeping interface.
+ *
+ * Simulated time only advances when the simulation calls
+ * host_systick_advance(), which stands in for one SysTick interrupt.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <time.h>
+#include "systick.h"
+#include "host.h"
+
+#define INTERVAL_MS 1000
+
+ticktime_t time_var = 0;
+
+void init_systick(void)
+{
+}
+
+void SysTick_Handler(void)
+{
+   time_var++;
+}
+
+void set_tick_source(TickSource source)
+{
+   (void)source;
+}
+
+void external_tick(void)
+{
+}
+
+uint32_t systick_count(void)
+{
+   return get_time_us();
+}
+
+uint32_t systick_elapsed_us(uint32_t start)
+{
+   return get_time_us() - start;
+}
+
+void reset_timer()
+{
+   time_var = 0;
+}
+
+ticktime_t get_current_tick()
+{
+   return time_var;
+}
+
+uint32_t time_since_startup()
+{
+   return time_var * INTERVAL_MS;
+}
+
+/**
+ * @brief Measures durations in host CPU time, so the scheduler's run-time
+ *        accounting reports what the firmware code costs on the host.
+ */
+uint32_t get_time_us(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+/**
+ * @brief Simulates one SysTick interrupt.
+ */
+void host_systick_advance(void)
+{
+   SysTick_Handler();
+}
@@ -0,0 +1,81 @@
+/**
+ * @file    telemetry_decode.c
+ * @brief   Decoder of the binary telemetry stream (Src/telemetry.h).
+ *
+ * Reads a capture of the console UART, or the output of
+ * weather_station_host built with TELEMETRY=1, finds the frames by their
+ * sync bytes and CRC, skips anything else such as text logs, and prints
+ * one CSV line per frame. Gaps in the sequence numbers are reported.
+ *
+ * Usage: telemetry_decode [capture]     (standard input by default)
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include "telemetry.h"
+
+static const char *const state_names[] = { "NORMAL", "EMERGENCY", "USER" };
+
+int main(int argc, char *argv[])
+{
+   FILE *in = stdin;
+   uint8_t window[TELEMETRY_FRAME_SIZE];
+   size_t fill = 0;
+   unsigned long frames = 0, lost = 0, skipped = 0;
+   uint16_t expected = 0;
+   int c;
+
+   if (argc > 1)
+   {
+      in = fopen(argv[1], "rb");
+      if (in == NULL)
+      {
+         perror(argv[1]);
+         return 1;
+      }
+   }
+
+   printf("sequence,time_s,temperature_c,pressure_hpa,humidity_rh,state\n");
+   while ((c = fgetc(in)) != EOF)
+   {
+      TelemetrySample s;
+
+      window[fill++] = (uint8_t)c;
+      if (fill < TELEMETRY_FRAME_SIZE)
+      {
+         continue;
+      }
+
+      if (!telemetry_decode(window, &s))
+      {
+         // Not a frame here: slide by one byte
+         memmove(window, window + 1, --fill);
+         skipped++;
+         continue;
+      }
+      fill = 0;
+
+      if ((frames != 0) && (s.sequence != expected))
+      {
+         lost += (uint16_t)(s.sequence - expected);
+         fprintf(stderr, "sequence %u after %u: frames lost\n", s.sequence, (uint16_t)(expected - 1));
+      }
+      expected = s.sequence + 1;
+      frames++;
+
+      printf("%u,%lu,%.2f,%.2f,%.3f,%s\n", s.sequence, (unsigned long)s.time_s,
+             BME280_TEMP_TO_C(s.temperature), BME280_PRESS_TO_HPA(s.pressure),
+             BME280_HUM_TO_RH(s.humidity),
+             (s.state < sizeof(state_names) / sizeof(state_names[0])) ? state_names[s.state] : "?");
+   }
+
+   fprintf(stderr, "%lu frames, %lu lost, %lu bytes of other output skipped\n", frames, lost, skipped);
+   if (in != stdin)
+   {
+      fclose(in);
+   }
+   return 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file    timer_host.c
+ * @brief   Host implementation of the TIM7 LED blink timer and of the
+ *          TIM14 cycle counter.
+ *
+ * host_tim7_advance() counts simulated milliseconds and invokes the
+ * registered callback, like TIM7_IRQHandler(), each time the auto-reload
+ * value is reached. The TIM14 counter runs on host CPU time, scaled to
+ * TIM14_COUNTER_HZ.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include "timer.h"
+#include "host.h"
+
+#define TIM7_ARR_VAL 999
+
+static uint32_t tim7_arr = TIM7_ARR_VAL;
+static uint32_t tim7_cnt;
+static TimerCallback tim7_callback = NULL;
+
+void Init_TIM7(void)
+{
+   tim7_arr = TIM7_ARR_VAL;
+   tim7_cnt = 0;
+}
+
+void TIM7_SetCallback(TimerCallback callback)
+{
+   tim7_callback = callback;
+}
+
+void TIM7_SetPeriod(uint16_t arr)
+{
+   tim7_arr = arr;
+}
+
+/**
+ * @brief Advances TIM7 by a number of 1 ms timer ticks.
+ */
+void host_tim7_advance(uint32_t ms)
+{
+   while (ms--)
+   {
+      if (tim7_cnt++ == tim7_arr)
+      {
+         tim7_cnt = 0;
+         if (tim7_callback != NULL)
+         {
+            tim7_callback();
+         }
+      }
+   }
+}
+
+void Init_TIM14_Counter(void)
+{
+}
+
+uint32_t TIM14_GetCount(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint32_t)((ts.tv_sec * 1000000000ULL + ts.tv_nsec) * (TIM14_COUNTER_HZ / 1000000) / 1000);
+}
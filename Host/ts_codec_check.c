@@ -0,0 +1,296 @@
+/**
+ * @file    ts_codec_check.c
+ * @brief   Round-trip check of the compressed sample blocks of ts_codec.c.
+ *
+ * Sample sequences are encoded into blocks the way flash_log.c fills them,
+ * a new block whenever ts_encode() refuses a sample, and every block is
+ * decoded again with ts_decode() and ts_block_read(). Covered are:
+ *  - a steady sequence, one sample per second,
+ *  - gaps in the time, outliers and the extremes of each field, where the
+ *    differences wrap around 2^32,
+ *  - a block filled to the last byte, and one sample too many,
+ *  - the UINT8_MAX sample count of the block header,
+ *  - ts_block_read() past the last sample, and a corrupt count,
+ *  - random walks with random gaps and outliers.
+ *
+ * The program prints every failed expectation and exits with status 1 if
+ * there was one.
+ *
+ * Usage: ts_codec_check [-n samples] [-s seed]
+ *   -n  samples of the random walks (default 1000000)
+ *   -s  random seed (default 1)
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ts_codec.h"
+
+#define MAX_BLOCK_SAMPLES ((TS_BLOCK_SIZE - 1) / TS_FIELDS)   // One byte per field
+
+static unsigned failures;
+static uint32_t rng_state;
+
+#define EXPECT(cond) expect((cond), #cond, __LINE__)
+
+static void expect(bool ok, const char *what, int line)
+{
+   if (!ok)
+   {
+      printf("FAIL line %d: %s\n", line, what);
+      failures++;
+   }
+}
+
+static uint32_t rng_next(void)
+{
+   // xorshift32
+   rng_state ^= rng_state << 13;
+   rng_state ^= rng_state >> 17;
+   rng_state ^= rng_state << 5;
+   return rng_state;
+}
+
+static TsSample make_sample(uint32_t time_s, int32_t temperature, uint32_t pressure, uint32_t humidity)
+{
+   TsSample sample = { time_s, { temperature, pressure, humidity } };
+
+   return sample;
+}
+
+static bool same_sample(const TsSample *a, const TsSample *b)
+{
+   return (a->time_s == b->time_s) && (a->data.temperature == b->data.temperature) &&
+          (a->data.pressure == b->data.pressure) && (a->data.humidity == b->data.humidity);
+}
+
+/**
+ * @brief Checks that a block holds exactly the given samples, through both
+ *        ts_decode() and ts_block_read().
+ */
+static void check_block(const uint8_t *block, const TsSample *samples, uint8_t count)
+{
+   TsDecoder dec;
+   TsSample sample;
+
+   EXPECT(ts_block_count(block) == count);
+
+   ts_decoder_init(&dec, block);
+   for (uint8_t i = 0; i < count; i++)
+   {
+      EXPECT(ts_decode(&dec, &sample) && same_sample(&sample, &samples[i]));
+   }
+   EXPECT(!ts_decode(&dec, &sample));
+
+   for (uint8_t i = 0; i < count; i++)
+   {
+      EXPECT(ts_block_read(block, i, &sample) && same_sample(&sample, &samples[i]));
+   }
+   EXPECT(!ts_block_read(block, count, &sample));
+}
+
+/**
+ * @brief Encodes a sequence into as many blocks as it needs and decodes
+ *        each block as soon as it is full.
+ *
+ * @return uint32_t Number of blocks used.
+ */
+static uint32_t round_trip(const TsSample *samples, uint32_t count)
+{
+   uint8_t block[TS_BLOCK_SIZE];
+   TsEncoder enc;
+   uint32_t first = 0;
+   uint32_t blocks = 1;
+
+   ts_encoder_init(&enc, block);
+   for (uint32_t i = 0; i < count; i++)
+   {
+      if (ts_encode(&enc, &samples[i]))
+      {
+         continue;
+      }
+      // A sample that does not fit always fits into an empty block
+      EXPECT(i > first);
+      check_block(block, &samples[first], (uint8_t)(i - first));
+      ts_encoder_init(&enc, block);
+      EXPECT(ts_encode(&enc, &samples[i]));
+      first = i;
+      blocks++;
+   }
+   check_block(block, &samples[first], (uint8_t)(count - first));
+   return blocks;
+}
+
+static void check_steady(void)
+{
+   TsSample samples[600];
+
+   for (uint32_t i = 0; i < 600; i++)
+   {
+      samples[i] = make_sample(1000 + i, 2150 + (int32_t)(i % 7) - 3, 25939200 + (i % 13) * 16, 46080 + i % 5);
+   }
+   EXPECT(round_trip(samples, 600) > 1);
+}
+
+static void check_gaps_and_outliers(void)
+{
+   const TsSample samples[] = {
+      make_sample(0, 0, 0, 0),
+      make_sample(60, 2150, 25939200, 46080),
+      make_sample(120, 2151, 25939210, 46081),
+      make_sample(86520, 2152, 25939220, 46082),            // Day-long gap
+      make_sample(86580, -4000, 25939230, 46083),           // Outliers
+      make_sample(86640, 8500, 7680000, 0),
+      make_sample(86700, 2153, 28160000, 102400),
+      make_sample(86701, INT32_MIN, UINT32_MAX, UINT32_MAX), // Extremes: differences wrap
+      make_sample(86702, INT32_MAX, 0, 0),
+      make_sample(86703, INT32_MIN, UINT32_MAX, UINT32_MAX),
+      make_sample(UINT32_MAX, 0, 0, 0),                     // Time wraps
+      make_sample(5, 2150, 25939200, 46080),
+      make_sample(0, 0, 0, 0),                              // Time goes back
+   };
+
+   round_trip(samples, sizeof(samples) / sizeof(samples[0]));
+}
+
+static void check_block_full(void)
+{
+   TsSample samples[MAX_BLOCK_SAMPLES + 1];
+   uint8_t block[TS_BLOCK_SIZE];
+   uint8_t copy[TS_BLOCK_SIZE];
+   TsEncoder enc;
+   uint8_t count = 0;
+
+   // The first sample takes 2 + 2 + 2 + 1 bytes, every later one 4: the
+   // header and 31 samples fill the block exactly
+   for (uint8_t i = 0; i <= MAX_BLOCK_SAMPLES; i++)
+   {
+      samples[i] = make_sample(64 + i, 64, 64, 0);
+   }
+   ts_encoder_init(&enc, block);
+   while ((count <= MAX_BLOCK_SAMPLES) && ts_encode(&enc, &samples[count]))
+   {
+      count++;
+   }
+   EXPECT(count == MAX_BLOCK_SAMPLES);
+   EXPECT(enc.used == TS_BLOCK_SIZE);
+   check_block(block, samples, count);
+
+   // A refused sample leaves the block unchanged
+   memcpy(copy, block, TS_BLOCK_SIZE);
+   EXPECT(!ts_encode(&enc, &samples[count]));
+   EXPECT(memcmp(copy, block, TS_BLOCK_SIZE) == 0);
+
+   // One sample less leaves unused bytes, which stay zero
+   ts_encoder_init(&enc, block);
+   for (uint8_t i = 0; i < MAX_BLOCK_SAMPLES - 1; i++)
+   {
+      EXPECT(ts_encode(&enc, &samples[i]));
+   }
+   EXPECT(enc.used == TS_BLOCK_SIZE - TS_FIELDS);
+   for (uint16_t i = enc.used; i < TS_BLOCK_SIZE; i++)
+   {
+      EXPECT(block[i] == 0);
+   }
+
+   // A count beyond the encoded samples runs off the end of a full block
+   ts_encoder_init(&enc, block);
+   for (uint8_t i = 0; i < MAX_BLOCK_SAMPLES; i++)
+   {
+      EXPECT(ts_encode(&enc, &samples[i]));
+   }
+   block[0]++;
+   EXPECT(!ts_block_read(block, MAX_BLOCK_SAMPLES, &samples[0]));
+}
+
+static void check_count_limit(void)
+{
+   const TsSample sample = make_sample(1, 0, 0, 0);
+   uint8_t block[TS_BLOCK_SIZE];
+   uint8_t copy[TS_BLOCK_SIZE];
+   TsEncoder enc;
+
+   // No block of real samples gets there; the count byte must still not wrap
+   ts_encoder_init(&enc, block);
+   EXPECT(ts_encode(&enc, &sample));
+   block[0] = UINT8_MAX - 1;
+   EXPECT(ts_encode(&enc, &sample));
+   EXPECT(ts_block_count(block) == UINT8_MAX);
+
+   memcpy(copy, block, TS_BLOCK_SIZE);
+   EXPECT(!ts_encode(&enc, &sample));
+   EXPECT(memcmp(copy, block, TS_BLOCK_SIZE) == 0);
+}
+
+/**
+ * @brief Random walks of every field with random gaps and outliers.
+ */
+static void check_random(uint32_t count)
+{
+   TsSample *samples = malloc(count * sizeof(*samples));
+   TsSample s = make_sample(0, 2150, 25939200, 46080);
+   uint32_t blocks;
+
+   if (samples == NULL)
+   {
+      EXPECT(samples != NULL);
+      return;
+   }
+   for (uint32_t i = 0; i < count; i++)
+   {
+      uint32_t r = rng_next();
+
+      s.time_s += ((r & 0xFF) == 0) ? rng_next() % 100000 : 60;
+      s.data.temperature += (int32_t)((r >> 8) % 5) - 2;
+      s.data.pressure += ((r >> 12) % 33) - 16;
+      s.data.humidity += ((r >> 20) % 9) - 4;
+      samples[i] = s;
+      if ((r >> 28) == 0)
+      {
+         samples[i].data.temperature = (int32_t)rng_next();
+         samples[i].data.pressure = rng_next();
+         samples[i].data.humidity = rng_next();
+      }
+   }
+   blocks = round_trip(samples, count);
+   printf("random: %lu samples in %lu blocks, %.1f bytes per sample\n", (unsigned long)count,
+          (unsigned long)blocks, (double)blocks * TS_BLOCK_SIZE / count);
+   free(samples);
+}
+
+int main(int argc, char *argv[])
+{
+   uint32_t count = 1000000;
+   int opt;
+
+   rng_state = 1;
+   while ((opt = getopt(argc, argv, "n:s:")) != -1)
+   {
+      switch (opt)
+      {
+      case 'n':
+         count = strtoul(optarg, NULL, 0);
+         break;
+      case 's':
+         rng_state = strtoul(optarg, NULL, 0);
+         rng_state += (rng_state == 0);
+         break;
+      default:
+         fprintf(stderr, "usage: %s [-n samples] [-s seed]\n", argv[0]);
+         return 2;
+      }
+   }
+
+   check_steady();
+   check_gaps_and_outliers();
+   check_block_full();
+   check_count_limit();
+   check_random(count);
+
+   printf("ts_codec: %u failure%s\n", failures, (failures == 1) ? "" : "s");
+   return (failures == 0) ? 0 : 1;
+}
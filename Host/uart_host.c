@@ -0,0 +1,35 @@
+/**
+ * @file    uart_host.c
+ * @brief   Host implementation of the console transmit interface.
+ *
+ * The host build writes the console to stdout through the C library, so
+ * nothing is ever queued or dropped.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include "uart.h"
+
+void Init_UART_TX(void)
+{
+}
+
+uint16_t UART_TX_Space(void)
+{
+   return UART_TX_BUFFER_SIZE;
+}
+
+bool UART_TX_Is_Idle(void)
+{
+   return true;
+}
+
+void UART_TX_Flush(void)
+{
+}
+
+void UART_Get_Stats(UART_Stats *stats)
+{
+   *stats = (UART_Stats){ 0 };
+}
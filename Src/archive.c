@@ -0,0 +1,233 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    archive.c
+ * @brief   Hierarchical downsampling archive of the sensor channels.
+ *
+ * Samples arrive once per second. The minimum, maximum and sum of each
+ * channel over 60 samples come from the minute block statistics.c closes
+ * for its windows, and are stored as a minute record; every 60 minute
+ * records are rolled up into an hour record. Each tier is a
+ * fixed-size RingBuffer that drops its oldest record when full, so the
+ * archive always holds the last hour at one minute resolution and the last
+ * two days at one hour resolution, in 40 bytes per record:
+ * (ARCHIVE_MINUTES + ARCHIVE_HOURS) x 40 = 4320 bytes.
+ *
+ * A "minute" is 60 samples rather than 60 s of wall time; a sample the
+ * sensor missed does not leave a hole in a record.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#define LOG_MODULE LOG_MODULE_ARCHIVE
+#include <stdio.h>
+#include "archive.h"
+#include "log.h"
+
+#define SAMPLES_PER_MINUTE STATS_SAMPLES_PER_MINUTE
+#define MINUTES_PER_HOUR   60
+#define REPORT_HOURS       24
+
+RING_BUFFER_DEFINE(archive_minutes, ArchiveRecord, ARCHIVE_MINUTES);
+RING_BUFFER_DEFINE(archive_hours, ArchiveRecord, ARCHIVE_HOURS);
+
+static RingBuffer *const tiers[ARCHIVE_TIER_COUNT] = { &archive_minutes, &archive_hours };
+
+static StatsBlock hour_acc[STATS_CHANNEL_COUNT];
+static uint32_t minute_count;       // Minutes since Init_Archive()
+static uint32_t hour_start;         // Sample count at the start of the current hour
+static uint8_t hour_minutes;        // Minutes in the current hour
+
+/**
+ * @brief Adds a minute block to the hour being built.
+ *
+ * @param acc    Accumulator of the hour.
+ * @param first  true if this starts a new hour.
+ * @param minute Minute block.
+ */
+static void accumulate(StatsBlock *acc, bool first, const StatsBlock *minute)
+{
+   if (first)
+   {
+      *acc = (StatsBlock){ minute->min, minute->max, 0 };
+   }
+   if (minute->min < acc->min)
+   {
+      acc->min = minute->min;
+   }
+   if (minute->max > acc->max)
+   {
+      acc->max = minute->max;
+   }
+   acc->sum += minute->sum;
+}
+
+/**
+ * @brief Returns sum / n rounded to the nearest integer.
+ */
+static int32_t rounded_mean(int64_t sum, uint32_t n)
+{
+   return (int32_t)((sum >= 0) ? (sum + n / 2) / (int64_t)n : -((-sum + n / 2) / (int64_t)n));
+}
+
+/**
+ * @brief Builds a record from blocks and appends it to a tier, dropping
+ *        the oldest record of a full tier.
+ *
+ * @param tier    Tier to append to.
+ * @param acc     One block per channel.
+ * @param samples Samples covered by the record.
+ * @param start_s Sample count at the first sample of the record.
+ */
+static void store_record(ArchiveTier tier, const StatsBlock *acc, uint32_t samples, uint32_t start_s)
+{
+   RingBuffer *ring = tiers[tier];
+   ArchiveRecord record = { .start_s = start_s };
+
+   for (uint8_t i = 0; i < STATS_CHANNEL_COUNT; i++)
+   {
+      record.channel[i].min = acc[i].min;
+      record.channel[i].mean = rounded_mean(acc[i].sum, samples);
+      record.channel[i].max = acc[i].max;
+   }
+
+   if (ring_is_full(ring))
+   {
+      ring_discard(ring, 1);
+   }
+   ring_push(ring, &record);
+}
+
+/**
+ * @brief Empties both tiers and starts a new minute and hour.
+ */
+void Init_Archive(void)
+{
+   for (uint8_t t = 0; t < ARCHIVE_TIER_COUNT; t++)
+   {
+      ring_reset(tiers[t]);
+   }
+   minute_count = 0;
+   hour_start = 0;
+   hour_minutes = 0;
+}
+
+/**
+ * @brief Archives the minute block statistics.c has just closed, and the
+ *        hour record it completes.
+ *
+ * Call it whenever statistics_add_sample() returns true. Both modules are
+ * reset together by Init_DataAcquisition(), so their minutes line up.
+ *
+ * @return bool true if a minute record was stored.
+ */
+bool archive_add_minute(void)
+{
+   StatsBlock minute[STATS_CHANNEL_COUNT];
+   uint32_t minute_start = minute_count * SAMPLES_PER_MINUTE;
+
+   for (uint8_t i = 0; i < STATS_CHANNEL_COUNT; i++)
+   {
+      if (!statistics_last_minute((StatsChannel)i, &minute[i]))
+      {
+         return false;
+      }
+   }
+   minute_count++;
+   store_record(ARCHIVE_TIER_MINUTE, minute, SAMPLES_PER_MINUTE, minute_start);
+
+   if (hour_minutes == 0)
+   {
+      hour_start = minute_start;
+   }
+   for (uint8_t i = 0; i < STATS_CHANNEL_COUNT; i++)
+   {
+      accumulate(&hour_acc[i], hour_minutes == 0, &minute[i]);
+   }
+
+   if (++hour_minutes == MINUTES_PER_HOUR)
+   {
+      hour_minutes = 0;
+      store_record(ARCHIVE_TIER_HOUR, hour_acc, SAMPLES_PER_MINUTE * MINUTES_PER_HOUR, hour_start);
+   }
+   return true;
+}
+
+/**
+ * @brief Returns the number of records held by a tier.
+ */
+uint16_t archive_count(ArchiveTier tier)
+{
+   return (tier < ARCHIVE_TIER_COUNT) ? ring_length(tiers[tier]) : 0;
+}
+
+/**
+ * @brief Copies one record of a tier.
+ *
+ * @param tier Tier.
+ * @param age  0 for the newest record, 1 for the one before, and so on.
+ * @param[out] record Receives the record.
+ * @return bool false if the tier holds fewer than age + 1 records.
+ */
+bool archive_get(ArchiveTier tier, uint16_t age, ArchiveRecord *record)
+{
+   uint16_t count = archive_count(tier);
+
+   if (age >= count)
+   {
+      return false;
+   }
+   return ring_peek(tiers[tier], count - 1 - age, record) == 1;
+}
+
+/**
+ * @brief Gives in-place access to all records of a tier, oldest first.
+ *
+ * @param tier Tier.
+ * @param[out] spans Receives up to two contiguous spans of ArchiveRecord.
+ * @return uint8_t Number of spans used (0, 1 or 2).
+ */
+uint8_t archive_window(ArchiveTier tier, RingSpan spans[2])
+{
+   if (tier >= ARCHIVE_TIER_COUNT)
+   {
+      return 0;
+   }
+   return ring_window(tiers[tier], spans);
+}
+
+/**
+ * @brief Logs the hourly trend of the last REPORT_HOURS hours, oldest first.
+ */
+void archive_report(void)
+{
+   uint16_t hours = archive_count(ARCHIVE_TIER_HOUR);
+
+   if (hours > REPORT_HOURS)
+   {
+      hours = REPORT_HOURS;
+   }
+   LOG_EVENT(LOG_ARCHIVE_SUMMARY, archive_count(ARCHIVE_TIER_MINUTE), archive_count(ARCHIVE_TIER_HOUR));
+
+   for (uint16_t age = hours; age > 0; age--)
+   {
+      ArchiveRecord r;
+      archive_get(ARCHIVE_TIER_HOUR, age - 1, &r);
+      LOG_EVENT(LOG_ARCHIVE_HOUR, age,
+                r.channel[STATS_TEMPERATURE].min,
+                r.channel[STATS_TEMPERATURE].mean,
+                r.channel[STATS_TEMPERATURE].max,
+                r.channel[STATS_PRESSURE].mean,
+                r.channel[STATS_HUMIDITY].mean);
+   }
+}
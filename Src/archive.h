@@ -0,0 +1,66 @@
+#ifndef __ARCHIVE_H
+#define __ARCHIVE_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    archive.h
+ * @brief   Tiered in-RAM time-series archive: 1 s samples are rolled up into
+ *          per-minute records, and those into hourly records.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "buffer.h"
+#include "statistics.h"
+
+#define ARCHIVE_MINUTES 60   // Minute records kept, one hour
+#define ARCHIVE_HOURS   48   // Hour records kept, two days
+
+typedef enum
+{
+   ARCHIVE_TIER_MINUTE,
+   ARCHIVE_TIER_HOUR,
+   ARCHIVE_TIER_COUNT
+} ArchiveTier;
+
+/**
+ * @brief Summary of one channel over one record, in the units of the
+ *        corresponding BME280_FixedData field.
+ */
+typedef struct
+{
+   int32_t min;
+   int32_t mean;
+   int32_t max;
+} ArchiveStat;
+
+/**
+ * @brief One minute or one hour of samples.
+ */
+typedef struct
+{
+   uint32_t start_s;                          // Sample count at the first sample
+   ArchiveStat channel[STATS_CHANNEL_COUNT];  // Indexed by StatsChannel
+} ArchiveRecord;
+
+void Init_Archive(void);
+bool archive_add_minute(void);
+uint16_t archive_count(ArchiveTier tier);
+bool archive_get(ArchiveTier tier, uint16_t age, ArchiveRecord *record);
+uint8_t archive_window(ArchiveTier tier, RingSpan spans[2]);
+void archive_report(void);
+
+#endif
@@ -8,9 +8,11 @@
  * @date    12/02/2025
  *
  */
+#include <stddef.h>
 #include "spi.h"
 #include "i2c.h"
 #include "bme280.h"
+#include "profiler.h"
 
 
 // BME280 Register Addresses
@@ -31,89 +33,102 @@
 // Expected chip ID
 #define BME280_CHIP_ID          0x60
 
+// STATUS register bits
+#define BME280_STATUS_MEASURING 0x08    // Conversion running
+#define BME280_STATUS_IM_UPDATE 0x01    // NVM data being copied
 
-// BME280 calibration parameters
-typedef struct {
-    uint16_t dig_T1;
-    int16_t  dig_T2;
-    int16_t  dig_T3;
-    
-    uint16_t dig_P1;
-    int16_t  dig_P2;
-    int16_t  dig_P3;
-    int16_t  dig_P4;
-    int16_t  dig_P5;
-    int16_t  dig_P6;
-    int16_t  dig_P7;
-    int16_t  dig_P8;
-    int16_t  dig_P9;
-    
-    uint8_t  dig_H1;
-    int16_t  dig_H2;
-    uint8_t  dig_H3;
-    int16_t  dig_H4;
-    int16_t  dig_H5;
-    int8_t   dig_H6;
-} BME280_CalibData;
+// Length of the measurement data burst (0xF7 to 0xFE)
+#define BME280_DATA_LEN         8
+
+// Maximum measurement time model, datasheet section 9.1 (µs)
+#define BME280_T_INIT_MAX_US    1250
+#define BME280_T_STEP_MAX_US    2300    // Per oversampled conversion
+#define BME280_T_PH_MAX_US      575     // Extra setup of pressure and humidity
 
-#define BME280_I2C_ADDR 0x76
+// Configurations follow the datasheet's use cases (section 3.5)
+const BME280_Config bme280_profiles[BME280_PROFILE_COUNT] = {
+    [BME280_PROFILE_WEATHER] = { BME280_OSRS_X1, BME280_OSRS_X1, BME280_OSRS_X1,
+                                 BME280_FILTER_OFF, BME280_STANDBY_500_MS, BME280_MODE_FORCED },
+    [BME280_PROFILE_INDOOR]  = { BME280_OSRS_X2, BME280_OSRS_X16, BME280_OSRS_X1,
+                                 BME280_FILTER_16, BME280_STANDBY_0_5_MS, BME280_MODE_NORMAL },
+    [BME280_PROFILE_FAST]    = { BME280_OSRS_X1, BME280_OSRS_X4, BME280_OSRS_X1,
+                                 BME280_FILTER_2, BME280_STANDBY_0_5_MS, BME280_MODE_NORMAL },
+};
+
+// Standby time per t_sb code (µs)
+static const uint32_t standby_us[8] = {
+    500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000
+};
 
-// Global calibration data
-BME280_CalibData calib;
-int32_t t_fine;  // Used for temperature compensation
 
 /**
  * @brief Writes a single byte to a BME280 register.
  *
  * Sends a command to write a value to the given register address
- * using either SPI or I2C depending on the build configuration.
+ * over the bus the sensor is connected to.
  *
+ * @param dev   Sensor to access.
  * @param reg   Register address to write to.
  * @param value Byte value to write into the register.
  */
-void BME280_WriteReg(const uint8_t reg, const uint8_t value)
+void BME280_WriteReg(const BME280_Dev *dev, const uint8_t reg, const uint8_t value)
 {
-#ifdef RUN_WITH_SPI
-    SPI_Write(reg & 0x7F, value); // Write: clear MSB
-#else
-    I2C_WriteReg(BME280_I2C_ADDR, reg, &value, 1);
-#endif
+    if (dev->bus == BME280_BUS_SPI) {
+        SPI_Select(dev->address);
+        SPI_Write(reg & 0x7F, value); // Write: clear MSB
+    } else {
+        I2C_WriteReg(dev->address, reg, &value, 1);
+    }
 }
 
 /**
  * @brief Reads a single byte from a BME280 register.
  *
- * Retrieves a value from the specified register using either
- * SPI or I2C depending on the build configuration.
+ * Retrieves a value from the specified register over the bus the
+ * sensor is connected to.
  *
+ * @param dev Sensor to access.
  * @param reg Register address to read from.
  * @return uint8_t Value read from the register.
  */
-uint8_t BME280_ReadReg(const uint8_t reg)
+uint8_t BME280_ReadReg(const BME280_Dev *dev, const uint8_t reg)
 {
-#ifdef RUN_WITH_SPI
-    return SPI_Read(reg);
-#else
-    uint8_t read_val;
-    I2C_ReadReg(BME280_I2C_ADDR, reg, &read_val, 1);
+    if (dev->bus == BME280_BUS_SPI) {
+        SPI_Select(dev->address);
+        return SPI_Read(reg);
+    }
+
+    uint8_t read_val = 0;
+    I2C_ReadReg(dev->address, reg, &read_val, 1);
     return read_val;
-#endif
 }
 
 /**
- * @brief Reads multiple consecutive BME280 registers.
+ * @brief Reads multiple consecutive BME280 registers in a single burst.
  *
- * Repeatedly reads from the starting register address and stores
- * each value into the provided buffer.
+ * The BME280 auto-increments the register address during a read, so the
+ * whole block is clocked out in one bus transaction: a single
+ * address + repeated-start sequence on I2C, or one chip-select assertion
+ * on SPI. SPI blocks are clocked by DMA; the polled burst is only used if
+ * the DMA channels are unavailable.
  *
+ * @param dev     Sensor to access.
  * @param reg     Starting register address.
  * @param buffer  Pointer to buffer to store read values.
  * @param len     Number of bytes to read.
+ * @return uint8_t 1 if the read succeeded, 0 on a bus error (I2C only).
  */
-void BME280_ReadRegs(uint8_t reg, uint8_t *buffer, uint8_t len) {    
-    for (uint8_t i = 0; i < len; i++) {
-        buffer[i] = BME280_ReadReg(reg++);
+uint8_t BME280_ReadRegs(const BME280_Dev *dev, uint8_t reg, uint8_t *buffer, uint8_t len) {
+    if (dev->bus == BME280_BUS_SPI) {
+        SPI_Select(dev->address);
+        if (SPI_DMA_ReadBurst(reg, buffer, len, NULL) && SPI_DMA_Wait()) {
+            return 1;
+        }
+        SPI_ReadBurst(reg, buffer, len);
+        return 1;
     }
+
+    return I2C_ReadReg(dev->address, reg, buffer, len) == I2C_OK;
 }
 
 // ========== BME280 Initialization ==========
@@ -123,85 +138,206 @@ void BME280_ReadRegs(uint8_t reg, uint8_t *buffer, uint8_t len) {
  * Performs a soft reset, verifies the chip ID, loads factory
  * calibration coefficients, and configures oversampling settings for
  * temperature, pressure, and humidity. Also sets the operating mode.
+ * The calibration is stored in the device handle, so any number of
+ * sensors can be initialized and used independently.
  *
+ * @param dev Sensor to initialize; bus and address must be set.
  * @return uint8_t Returns 1 on successful initialization, 0 if the
- *                 chip ID does not match the expected value.
+ *                 chip ID does not match the expected value or the
+ *                 calibration could not be read.
  */
-uint8_t BME280_Init(void) {
+uint8_t BME280_Init(BME280_Dev *dev) {
+    BME280_CalibData *calib = &dev->calib;
     uint8_t chip_id;
     uint8_t calib_data[32];
     
     // Check chip ID
-    chip_id = BME280_ReadReg(BME280_REG_CHIP_ID);
+    chip_id = BME280_ReadReg(dev, BME280_REG_CHIP_ID);
     if (chip_id != BME280_CHIP_ID) {
         return 0;  // Wrong chip ID
     }
     
     // Soft reset
-    BME280_WriteReg(BME280_REG_RESET, 0xB6);
+    BME280_WriteReg(dev, BME280_REG_RESET, 0xB6);
     
     // Wait for reset to complete
     for (volatile int i = 0; i < 100000; i++);
     
-    // Read calibration data (Temperature & Pressure)
-    BME280_ReadRegs(BME280_REG_CALIB_00, calib_data, 26);
+    // Read calibration data (Temperature & Pressure), 0x88 to 0xA1
+    if (!BME280_ReadRegs(dev, BME280_REG_CALIB_00, calib_data, 26)) {
+        return 0;  // Calibration unreadable
+    }
     
-    calib.dig_T1 = (calib_data[1] << 8) | calib_data[0];
-    calib.dig_T2 = (calib_data[3] << 8) | calib_data[2];
-    calib.dig_T3 = (calib_data[5] << 8) | calib_data[4];
+    calib->dig_T1 = (calib_data[1] << 8) | calib_data[0];
+    calib->dig_T2 = (calib_data[3] << 8) | calib_data[2];
+    calib->dig_T3 = (calib_data[5] << 8) | calib_data[4];
     
-    calib.dig_P1 = (calib_data[7] << 8) | calib_data[6];
-    calib.dig_P2 = (calib_data[9] << 8) | calib_data[8];
-    calib.dig_P3 = (calib_data[11] << 8) | calib_data[10];
-    calib.dig_P4 = (calib_data[13] << 8) | calib_data[12];
-    calib.dig_P5 = (calib_data[15] << 8) | calib_data[14];
-    calib.dig_P6 = (calib_data[17] << 8) | calib_data[16];
-    calib.dig_P7 = (calib_data[19] << 8) | calib_data[18];
-    calib.dig_P8 = (calib_data[21] << 8) | calib_data[20];
-    calib.dig_P9 = (calib_data[23] << 8) | calib_data[22];
+    calib->dig_P1 = (calib_data[7] << 8) | calib_data[6];
+    calib->dig_P2 = (calib_data[9] << 8) | calib_data[8];
+    calib->dig_P3 = (calib_data[11] << 8) | calib_data[10];
+    calib->dig_P4 = (calib_data[13] << 8) | calib_data[12];
+    calib->dig_P5 = (calib_data[15] << 8) | calib_data[14];
+    calib->dig_P6 = (calib_data[17] << 8) | calib_data[16];
+    calib->dig_P7 = (calib_data[19] << 8) | calib_data[18];
+    calib->dig_P8 = (calib_data[21] << 8) | calib_data[20];
+    calib->dig_P9 = (calib_data[23] << 8) | calib_data[22];
     
-    calib.dig_H1 = calib_data[25];
+    calib->dig_H1 = calib_data[25];
     
-    // Read calibration data (Humidity)
-    BME280_ReadRegs(BME280_REG_CALIB_26, calib_data, 7);
+    // Read calibration data (Humidity), 0xE1 to 0xE7
+    if (!BME280_ReadRegs(dev, BME280_REG_CALIB_26, calib_data, 7)) {
+        return 0;  // Calibration unreadable
+    }
     
-    calib.dig_H2 = (calib_data[1] << 8) | calib_data[0];
-    calib.dig_H3 = calib_data[2];
-    calib.dig_H4 = (calib_data[3] << 4) | (calib_data[4] & 0x0F);
-    calib.dig_H5 = (calib_data[5] << 4) | (calib_data[4] >> 4);
-    calib.dig_H6 = calib_data[6];
+    calib->dig_H2 = (calib_data[1] << 8) | calib_data[0];
+    calib->dig_H3 = calib_data[2];
+    calib->dig_H4 = (calib_data[3] << 4) | (calib_data[4] & 0x0F);
+    calib->dig_H5 = (calib_data[5] << 4) | (calib_data[4] >> 4);
+    calib->dig_H6 = calib_data[6];
     
     // Configure sensor
-    // Humidity oversampling x1
-    BME280_WriteReg(BME280_REG_CTRL_HUM, 0x01);
-    
-    // Temperature oversampling x1, Pressure oversampling x1, Normal mode
-    BME280_WriteReg(BME280_REG_CTRL_MEAS, 0x27);
-    
-    // Standby time 0.5ms, filter off
-    BME280_WriteReg(BME280_REG_CONFIG, 0x00);
+    BME280_Configure(dev, (dev->config != NULL) ? dev->config : &bme280_profiles[BME280_PROFILE_WEATHER]);
     
     return 1;  // Success
 }
 
+/**
+ * @brief Applies a measurement configuration to a sensor.
+ *
+ * The sensor is put to sleep first because writes to CONFIG may be ignored
+ * in normal mode. CTRL_HUM only takes effect after CTRL_MEAS is written,
+ * so CTRL_MEAS, which also selects the mode, is written last.
+ *
+ * @param dev    Sensor to configure.
+ * @param config Configuration to apply; must stay valid while in use.
+ */
+void BME280_Configure(BME280_Dev *dev, const BME280_Config *config) {
+    uint8_t ctrl_meas = (config->osrs_t << 5) | (config->osrs_p << 2);
+
+    BME280_WriteReg(dev, BME280_REG_CTRL_MEAS, ctrl_meas | BME280_MODE_SLEEP);
+    BME280_WriteReg(dev, BME280_REG_CONFIG, (config->standby << 5) | (config->filter << 2));
+    BME280_WriteReg(dev, BME280_REG_CTRL_HUM, config->osrs_h);
+    BME280_WriteReg(dev, BME280_REG_CTRL_MEAS, ctrl_meas | config->mode);
+
+    dev->config = config;
+}
+
+/**
+ * @brief Applies one of the predefined configurations to a sensor.
+ *
+ * @param dev     Sensor to configure.
+ * @param profile Entry of bme280_profiles[].
+ */
+void BME280_SetProfile(BME280_Dev *dev, BME280_Profile profile) {
+    if (profile < BME280_PROFILE_COUNT) {
+        BME280_Configure(dev, &bme280_profiles[profile]);
+    }
+}
+
+/**
+ * @brief Returns the configuration a sensor is running with.
+ */
+static const BME280_Config *BME280_ActiveConfig(const BME280_Dev *dev) {
+    return (dev->config != NULL) ? dev->config : &bme280_profiles[BME280_PROFILE_WEATHER];
+}
+
+/**
+ * @brief Starts a single measurement in forced mode.
+ *
+ * The sensor performs one conversion with the oversampling of its active
+ * configuration, stores the result and returns to sleep mode.
+ *
+ * @param dev Sensor to trigger.
+ */
+void BME280_TriggerForced(BME280_Dev *dev) {
+    const BME280_Config *config = BME280_ActiveConfig(dev);
+
+    BME280_WriteReg(dev, BME280_REG_CTRL_MEAS,
+                    (config->osrs_t << 5) | (config->osrs_p << 2) | BME280_MODE_FORCED);
+}
+
+/**
+ * @brief Checks whether a conversion is still running.
+ *
+ * @param dev Sensor to query.
+ * @return uint8_t 1 while the measuring bit of STATUS is set, 0 when the
+ *                 data registers hold the result of the last conversion.
+ */
+uint8_t BME280_IsMeasuring(const BME280_Dev *dev) {
+    return (BME280_ReadReg(dev, BME280_REG_STATUS) & BME280_STATUS_MEASURING) != 0;
+}
+
+/**
+ * @brief Number of conversions averaged for an oversampling setting.
+ */
+static uint32_t BME280_OversamplingFactor(BME280_Oversampling osrs) {
+    return (osrs == BME280_OSRS_SKIP) ? 0 : (1U << (osrs - 1));
+}
+
+/**
+ * @brief Maximum time of one conversion (datasheet t_measure,max).
+ *
+ * After this time a triggered measurement is guaranteed to be complete.
+ *
+ * @param config Configuration to evaluate.
+ * @return uint32_t Measurement time in µs.
+ */
+uint32_t BME280_MeasureTimeUs(const BME280_Config *config) {
+    uint32_t t = BME280_T_INIT_MAX_US + BME280_T_STEP_MAX_US * BME280_OversamplingFactor(config->osrs_t);
+
+    if (config->osrs_p != BME280_OSRS_SKIP) {
+        t += BME280_T_STEP_MAX_US * BME280_OversamplingFactor(config->osrs_p) + BME280_T_PH_MAX_US;
+    }
+    if (config->osrs_h != BME280_OSRS_SKIP) {
+        t += BME280_T_STEP_MAX_US * BME280_OversamplingFactor(config->osrs_h) + BME280_T_PH_MAX_US;
+    }
+    return t;
+}
+
+/**
+ * @brief Time between two fresh results of a configuration.
+ *
+ * In normal mode the sensor alternates between a measurement and the
+ * standby time; in forced mode one result is available t_measure after
+ * each trigger.
+ *
+ * @param config Configuration to evaluate.
+ * @return uint32_t Output data period in µs.
+ */
+uint32_t BME280_SamplePeriodUs(const BME280_Config *config) {
+    uint32_t period = BME280_MeasureTimeUs(config);
+
+    if (config->mode == BME280_MODE_NORMAL) {
+        period += standby_us[config->standby];
+    }
+    return period;
+}
+
 // ========== BME280 Compensation Functions ==========
 /**
  * @brief Compensates raw temperature ADC value.
  *
+ * Also stores t_fine in the device handle for the pressure and humidity
+ * compensation of the same measurement. The linear term is multiplied in
+ * 64 bits: near the top of the 20-bit range, with dig_T2 above about
+ * 28000, it no longer fits in 32.
+ *
+ * @param dev   Sensor the value was read from.
  * @param adc_T Raw temperature ADC value (20-bit).
  * @return int32_t Temperature in hundredths of a degree Celsius (°C × 100).
  */
-int32_t BME280_CompensateTemp(int32_t adc_T) {
+int32_t BME280_CompensateTemp(BME280_Dev *dev, int32_t adc_T) {
+    const BME280_CalibData *calib = &dev->calib;
     int32_t var1, var2, T;
     
-    var1 = ((((adc_T >> 3) - ((int32_t)calib.dig_T1 << 1))) * 
-            ((int32_t)calib.dig_T2)) >> 11;
-    var2 = (((((adc_T >> 4) - ((int32_t)calib.dig_T1)) * 
-            ((adc_T >> 4) - ((int32_t)calib.dig_T1))) >> 12) * 
-            ((int32_t)calib.dig_T3)) >> 14;
+    var1 = (int32_t)((((int64_t)((adc_T >> 3) - ((int32_t)calib->dig_T1 << 1))) * 
+            ((int32_t)calib->dig_T2)) >> 11);
+    var2 = (((((adc_T >> 4) - ((int32_t)calib->dig_T1)) * 
+            ((adc_T >> 4) - ((int32_t)calib->dig_T1))) >> 12) * 
+            ((int32_t)calib->dig_T3)) >> 14;
     
-    t_fine = var1 + var2;
-    T = (t_fine * 5 + 128) >> 8;
+    dev->t_fine = var1 + var2;
+    T = (dev->t_fine * 5 + 128) >> 8;
     
     return T;  // Temperature in 0.01°C
 }
@@ -209,19 +345,25 @@ int32_t BME280_CompensateTemp(int32_t adc_T) {
 /**
  * @brief Compensates raw pressure ADC value.
  *
+ * Raw values far outside the operating range give pressures below 0 or
+ * beyond what Pa/256 holds in 32 bits; the result saturates there instead
+ * of wrapping around.
+ *
+ * @param dev   Sensor the value was read from; t_fine must be current.
  * @param adc_P Raw pressure ADC value (20-bit).
  * @return uint32_t Compensated pressure in Pa/256.
  */
-uint32_t BME280_CompensatePressure(int32_t adc_P) {
+uint32_t BME280_CompensatePressure(const BME280_Dev *dev, int32_t adc_P) {
+    const BME280_CalibData *calib = &dev->calib;
     int64_t var1, var2, p;
     
-    var1 = ((int64_t)t_fine) - 128000;
-    var2 = var1 * var1 * (int64_t)calib.dig_P6;
-    var2 = var2 + ((var1 * (int64_t)calib.dig_P5) << 17);
-    var2 = var2 + (((int64_t)calib.dig_P4) << 35);
-    var1 = ((var1 * var1 * (int64_t)calib.dig_P3) >> 8) + 
-           ((var1 * (int64_t)calib.dig_P2) << 12);
-    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)calib.dig_P1) >> 33;
+    var1 = ((int64_t)dev->t_fine) - 128000;
+    var2 = var1 * var1 * (int64_t)calib->dig_P6;
+    var2 = var2 + ((var1 * (int64_t)calib->dig_P5) << 17);
+    var2 = var2 + (((int64_t)calib->dig_P4) << 35);
+    var1 = ((var1 * var1 * (int64_t)calib->dig_P3) >> 8) + 
+           ((var1 * (int64_t)calib->dig_P2) << 12);
+    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)calib->dig_P1) >> 33;
     
     if (var1 == 0) {
         return 0;  // Avoid division by zero
@@ -229,31 +371,39 @@ uint32_t BME280_CompensatePressure(int32_t adc_P) {
     
     p = 1048576 - adc_P;
     p = (((p << 31) - var2) * 3125) / var1;
-    var1 = (((int64_t)calib.dig_P9) * (p >> 13) * (p >> 13)) >> 25;
-    var2 = (((int64_t)calib.dig_P8) * p) >> 19;
-    p = ((p + var1 + var2) >> 8) + (((int64_t)calib.dig_P7) << 4);
+    var1 = (((int64_t)calib->dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (((int64_t)calib->dig_P8) * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (((int64_t)calib->dig_P7) << 4);
     
+    if (p < 0) {
+        return 0;
+    }
+    if (p > UINT32_MAX) {
+        return UINT32_MAX;
+    }
     return (uint32_t)p;  // Pressure in Pa/256
 }
 
 /**
  * @brief Compensates raw humidity ADC value.
  *
+ * @param dev   Sensor the value was read from; t_fine must be current.
  * @param adc_H Raw humidity ADC value (16-bit).
  * @return uint32_t Relative humidity in %RH × 1024.
  */
-uint32_t BME280_CompensateHumidity(int32_t adc_H) {
+uint32_t BME280_CompensateHumidity(const BME280_Dev *dev, int32_t adc_H) {
+    const BME280_CalibData *calib = &dev->calib;
     int32_t v_x1_u32r;
     
-    v_x1_u32r = (t_fine - ((int32_t)76800));
-    v_x1_u32r = (((((adc_H << 14) - (((int32_t)calib.dig_H4) << 20) - 
-                (((int32_t)calib.dig_H5) * v_x1_u32r)) + ((int32_t)16384)) >> 15) * 
-                (((((((v_x1_u32r * ((int32_t)calib.dig_H6)) >> 10) * 
-                (((v_x1_u32r * ((int32_t)calib.dig_H3)) >> 11) + ((int32_t)32768))) >> 10) + 
-                ((int32_t)2097152)) * ((int32_t)calib.dig_H2) + 8192) >> 14));
+    v_x1_u32r = (dev->t_fine - ((int32_t)76800));
+    v_x1_u32r = (((((adc_H << 14) - (((int32_t)calib->dig_H4) << 20) - 
+                (((int32_t)calib->dig_H5) * v_x1_u32r)) + ((int32_t)16384)) >> 15) * 
+                (((((((v_x1_u32r * ((int32_t)calib->dig_H6)) >> 10) * 
+                (((v_x1_u32r * ((int32_t)calib->dig_H3)) >> 11) + ((int32_t)32768))) >> 10) + 
+                ((int32_t)2097152)) * ((int32_t)calib->dig_H2) + 8192) >> 14));
     
     v_x1_u32r = (v_x1_u32r - (((((v_x1_u32r >> 15) * (v_x1_u32r >> 15)) >> 7) * 
-                ((int32_t)calib.dig_H1)) >> 4));
+                ((int32_t)calib->dig_H1)) >> 4));
     
     v_x1_u32r = (v_x1_u32r < 0 ? 0 : v_x1_u32r);
     v_x1_u32r = (v_x1_u32r > 419430400 ? 419430400 : v_x1_u32r);
@@ -263,34 +413,105 @@ uint32_t BME280_CompensateHumidity(int32_t adc_H) {
 
 // ========== BME280 Read All Measurements ==========
 /**
- * @brief Reads all environmental measurements from the BME280.
+ * @brief Parses the 8-byte data burst (0xF7 to 0xFE) into raw ADC values.
  *
- * Reads temperature, pressure, and humidity raw ADC values from the
- * sensor, applies compensation formulas, and stores the results in
- * floating-point format within the provided data structure.
+ * @param raw_data Registers 0xF7 to 0xFE.
+ * @param raw      Pointer to a BME280_RawData structure to fill.
+ */
+static void BME280_ParseRaw(const uint8_t *raw_data, BME280_RawData *raw) {
+    raw->adc_P = ((uint32_t)raw_data[0] << 12) | ((uint32_t)raw_data[1] << 4) | 
+                 ((uint32_t)raw_data[2] >> 4);
+    raw->adc_T = ((uint32_t)raw_data[3] << 12) | ((uint32_t)raw_data[4] << 4) | 
+                 ((uint32_t)raw_data[5] >> 4);
+    raw->adc_H = ((uint32_t)raw_data[6] << 8) | (uint32_t)raw_data[7];
+}
+
+/**
+ * @brief Compensates a raw measurement into fixed-point units.
+ *
+ * Temperature is compensated first since it provides t_fine for the
+ * pressure and humidity formulas.
  *
- * @param data Pointer to a BME280_Data structure where the
- *             compensated values will be stored. Fields returned:
- *             - temperature (°C)
- *             - pressure (hPa)
- *             - humidity (%RH)
+ * @param dev  Sensor the values were read from.
+ * @param raw  Raw ADC values.
+ * @param data Compensated result:
+ *             - temperature (°C x 100)
+ *             - pressure (Pa x 256)
+ *             - humidity (%RH x 1024)
  */
-void BME280_ReadAll(BME280_Data *data) {
-    uint8_t raw_data[8];
-    int32_t adc_T, adc_P, adc_H;
-    
-    // Read all sensor data (0xF7 to 0xFE)
-    BME280_ReadRegs(BME280_REG_PRESS_MSB, raw_data, 8);
-    
-    // Parse raw data
-    adc_P = ((uint32_t)raw_data[0] << 12) | ((uint32_t)raw_data[1] << 4) | 
-            ((uint32_t)raw_data[2] >> 4);
-    adc_T = ((uint32_t)raw_data[3] << 12) | ((uint32_t)raw_data[4] << 4) | 
-            ((uint32_t)raw_data[5] >> 4);
-    adc_H = ((uint32_t)raw_data[6] << 8) | (uint32_t)raw_data[7];
-    
-    // Compensate and convert to float
-    data->temperature = BME280_CompensateTemp(adc_T) / 100.0f;  // °C
-    data->pressure = BME280_CompensatePressure(adc_P) / 25600.0f;  // hPa
-    data->humidity = BME280_CompensateHumidity(adc_H) / 1024.0f;  // %
+void BME280_Compensate(BME280_Dev *dev, const BME280_RawData *raw, BME280_FixedData *data) {
+    data->temperature = BME280_CompensateTemp(dev, raw->adc_T);
+    data->pressure = BME280_CompensatePressure(dev, raw->adc_P);
+    data->humidity = BME280_CompensateHumidity(dev, raw->adc_H);
+}
+
+/**
+ * @brief Reads several sensors back to back in one acquisition cycle.
+ *
+ * The data bursts of all I2C sensors are queued at once, so the I2C
+ * interrupt handler clocks them out without gaps while SPI sensors are
+ * read by DMA. Compensation runs once the frames have arrived, each with
+ * its own calibration and t_fine.
+ *
+ * Only the sensors selected by mask are accessed, so a sensor that failed
+ * BME280_Init(), or has no new result, costs no bus transfer.
+ *
+ * @param devs  Array of sensors.
+ * @param count Number of sensors, at most BME280_MAX_SENSORS.
+ * @param mask  Sensors to read (bit i = devs[i]); each must be initialized.
+ * @param data  Array of count results, in the same order as devs.
+ * @return uint8_t Bit mask of the sensors read successfully, a subset of mask.
+ */
+uint8_t BME280_ReadSensors(BME280_Dev *devs, uint8_t count, uint8_t mask, BME280_FixedData *data) {
+    I2C_Transfer xfers[BME280_MAX_SENSORS];
+    uint8_t frames[BME280_MAX_SENSORS][BME280_DATA_LEN];
+    uint8_t ok_mask = 0;
+    BME280_RawData raw;
+    PROF_BEGIN(PROF_SCOPE_BME280_READ);
+
+    if (count > BME280_MAX_SENSORS) {
+        count = BME280_MAX_SENSORS;
+    }
+
+    // Queue all I2C bursts first so they run back to back
+    for (uint8_t i = 0; i < count; i++) {
+        if ((mask & (1U << i)) && (devs[i].bus == BME280_BUS_I2C)) {
+            xfers[i] = (I2C_Transfer){
+                .dev_adx = devs[i].address,
+                .reg_adx = BME280_REG_PRESS_MSB,
+                .bufp = frames[i],
+                .data_len = BME280_DATA_LEN,
+                .read = true,
+                .callback = NULL
+            };
+            if (I2C_Submit(&xfers[i]) != I2C_OK) {
+                xfers[i].status = I2C_BUSY;
+                xfers[i].done = true;
+            }
+        }
+    }
+
+    // SPI sensors share one chip-select-driven bus, read them in turn
+    for (uint8_t i = 0; i < count; i++) {
+        if (!(mask & (1U << i))) {
+            continue;
+        }
+        if (devs[i].bus == BME280_BUS_SPI) {
+            if (BME280_ReadRegs(&devs[i], BME280_REG_PRESS_MSB, frames[i], BME280_DATA_LEN)) {
+                ok_mask |= (1U << i);
+            }
+        } else if (I2C_Wait(&xfers[i]) == I2C_OK) {
+            ok_mask |= (1U << i);
+        }
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (ok_mask & (1U << i)) {
+            BME280_ParseRaw(frames[i], &raw);
+            BME280_Compensate(&devs[i], &raw, &data[i]);
+        }
+    }
+
+    PROF_END(PROF_SCOPE_BME280_READ);
+    return ok_mask;
 }
@@ -25,16 +25,142 @@
 
 //#define RUN_WITH_SPI 0
 
+#define BME280_I2C_ADDR_PRIMARY    0x76  // SDO connected to GND
+#define BME280_I2C_ADDR_SECONDARY  0x77  // SDO connected to VDDIO
+#define BME280_MAX_SENSORS         4     // Sensors per BME280_ReadSensors() call
 
-// BME280 measurement data
+// BME280 calibration parameters
 typedef struct {
-    float temperature;  // °C
-    float pressure;     // hPa
-    float humidity;     // %
-} BME280_Data;
+    uint16_t dig_T1;
+    int16_t  dig_T2;
+    int16_t  dig_T3;
+    
+    uint16_t dig_P1;
+    int16_t  dig_P2;
+    int16_t  dig_P3;
+    int16_t  dig_P4;
+    int16_t  dig_P5;
+    int16_t  dig_P6;
+    int16_t  dig_P7;
+    int16_t  dig_P8;
+    int16_t  dig_P9;
+    
+    uint8_t  dig_H1;
+    int16_t  dig_H2;
+    uint8_t  dig_H3;
+    int16_t  dig_H4;
+    int16_t  dig_H5;
+    int8_t   dig_H6;
+} BME280_CalibData;
 
-uint8_t BME280_Init(void);
-void BME280_ReadAll(BME280_Data *data);
+// Oversampling setting of one measurement (osrs_t, osrs_p, osrs_h fields)
+typedef enum {
+    BME280_OSRS_SKIP = 0,   // Measurement skipped, output set to 0x80000/0x8000
+    BME280_OSRS_X1   = 1,
+    BME280_OSRS_X2   = 2,
+    BME280_OSRS_X4   = 3,
+    BME280_OSRS_X8   = 4,
+    BME280_OSRS_X16  = 5
+} BME280_Oversampling;
+
+// IIR filter coefficient (filter field of CONFIG)
+typedef enum {
+    BME280_FILTER_OFF = 0,
+    BME280_FILTER_2   = 1,
+    BME280_FILTER_4   = 2,
+    BME280_FILTER_8   = 3,
+    BME280_FILTER_16  = 4
+} BME280_Filter;
+
+// Inactive time between conversions in normal mode (t_sb field of CONFIG)
+typedef enum {
+    BME280_STANDBY_0_5_MS  = 0,
+    BME280_STANDBY_62_5_MS = 1,
+    BME280_STANDBY_125_MS  = 2,
+    BME280_STANDBY_250_MS  = 3,
+    BME280_STANDBY_500_MS  = 4,
+    BME280_STANDBY_1000_MS = 5,
+    BME280_STANDBY_10_MS   = 6,
+    BME280_STANDBY_20_MS   = 7
+} BME280_Standby;
+
+// Sensor mode (mode field of CTRL_MEAS)
+typedef enum {
+    BME280_MODE_SLEEP  = 0,
+    BME280_MODE_FORCED = 1,
+    BME280_MODE_NORMAL = 3
+} BME280_Mode;
+
+// Complete measurement configuration
+typedef struct {
+    BME280_Oversampling osrs_t;
+    BME280_Oversampling osrs_p;
+    BME280_Oversampling osrs_h;
+    BME280_Filter filter;
+    BME280_Standby standby;
+    BME280_Mode mode;
+} BME280_Config;
+
+// Predefined configurations, see bme280_profiles[] in bme280.c
+typedef enum {
+    BME280_PROFILE_WEATHER,   // x1/x1/x1, filter off, forced: lowest power
+    BME280_PROFILE_INDOOR,    // x2/x16/x1, filter 16: lowest noise
+    BME280_PROFILE_FAST,      // x1/x4/x1, filter 2: short response time
+    BME280_PROFILE_COUNT
+} BME280_Profile;
+
+extern const BME280_Config bme280_profiles[BME280_PROFILE_COUNT];
+
+// Bus a sensor is connected to
+typedef enum {
+    BME280_BUS_I2C,
+    BME280_BUS_SPI
+} BME280_Bus;
+
+// One BME280 sensor: bus address plus its own calibration and t_fine
+typedef struct {
+    BME280_Bus bus;
+    uint8_t address;          // I2C: 7-bit slave address, SPI: GPIOB chip-select pin
+    BME280_CalibData calib;
+    int32_t t_fine;           // Carried from temperature into P/H compensation
+    const BME280_Config *config;  // Active configuration, NULL selects the weather profile
+} BME280_Dev;
+
+#define BME280_DEV_I2C(addr)    { .bus = BME280_BUS_I2C, .address = (addr) }
+#define BME280_DEV_SPI(cs_pin)  { .bus = BME280_BUS_SPI, .address = (cs_pin) }
+
+
+// Raw ADC values of one measurement burst (0xF7 to 0xFE)
+typedef struct {
+    int32_t adc_T;      // 20-bit
+    int32_t adc_P;      // 20-bit
+    int32_t adc_H;      // 16-bit
+} BME280_RawData;
+
+// Compensated BME280 measurement in fixed-point
+typedef struct {
+    int32_t temperature;  // °C x 100
+    uint32_t pressure;    // Pa x 256
+    uint32_t humidity;    // %RH x 1024
+} BME280_FixedData;
+
+// Conversions to engineering units, for display only
+#define BME280_TEMP_TO_C(t)      ((t) / 100.0f)
+#define BME280_PRESS_TO_HPA(p)   ((p) / 25600.0f)
+#define BME280_HUM_TO_RH(h)      ((h) / 1024.0f)
+
+uint8_t BME280_Init(BME280_Dev *dev);
+void BME280_Configure(BME280_Dev *dev, const BME280_Config *config);
+void BME280_SetProfile(BME280_Dev *dev, BME280_Profile profile);
+uint32_t BME280_MeasureTimeUs(const BME280_Config *config);
+uint32_t BME280_SamplePeriodUs(const BME280_Config *config);
+void BME280_TriggerForced(BME280_Dev *dev);
+uint8_t BME280_IsMeasuring(const BME280_Dev *dev);
+int32_t BME280_CompensateTemp(BME280_Dev *dev, int32_t adc_T);
+uint32_t BME280_CompensatePressure(const BME280_Dev *dev, int32_t adc_P);
+uint32_t BME280_CompensateHumidity(const BME280_Dev *dev, int32_t adc_H);
+void BME280_Compensate(BME280_Dev *dev, const BME280_RawData *raw, BME280_FixedData *data);
+uint8_t BME280_ReadSensors(BME280_Dev *devs, uint8_t count, uint8_t mask, BME280_FixedData *data);
 
 
 #endif
\ No newline at end of file
@@ -2,128 +2,330 @@
  * @file    buffer.c
  * @brief	This file contains the implementation of circular buffer.
  *
+ * Lock-free single-producer/single-consumer ring of fixed-size elements.
+ * The producer stores elements before publishing them by advancing head;
+ * the consumer copies elements out before releasing the slots by advancing
+ * tail. Both indices are 16-bit, so each is read and written with a single
+ * load or store. On the single-core Cortex-M0, memory accesses complete in
+ * program order, so only the compiler has to be kept from reordering the
+ * element access and the index update; BUFFER_BARRIER() does that.
+ *
+ * Indices run over 0 .. 2 x capacity - 1 and wrap by subtraction, so the
+ * capacity does not have to be a power of two and no division is needed.
+ *
  * @author  Venetia Furtado
  * @date    12/02/2025
  *
  */
-#include <stdbool.h>
+#include <string.h>
 #include "buffer.h"
 
 #define SUCCESS 1
 #define ERROR -1
+#define BUFFER_BARRIER() __asm volatile ("" ::: "memory")
+
 /**
- * @brief Initializes the head and tail of the circular buffer
- * 
- * @param Address of circular buffer
+ * @brief Advances an index by n slots, wrapping at 2 x capacity.
  */
-void init_buffer_with_default_val(BufferType* bufferLog)
+static inline uint16_t ring_advance(const RingBuffer *ring, uint16_t index, uint16_t n)
 {
-   bufferLog->head = 0;
-   bufferLog->tail = 0;
-   bufferLog->length = 0;
+   uint32_t next = (uint32_t)index + n;
+
+   if (next >= 2U * ring->capacity)
+   {
+      next -= 2U * ring->capacity;
+   }
+   return (uint16_t)next;
 }
 
 /**
- * @brief Checks is circular buffer is empty.
- * @param Address of circular buffer 
- * @return true if buffer is empty
- * @return false if buffer not empty
+ * @brief Returns the storage slot of an index.
  */
-bool is_buffer_empty(BufferType* bufferLog)
+static inline uint16_t ring_slot(const RingBuffer *ring, uint16_t index)
 {
-    return bufferLog->head == bufferLog->tail;
+   return (index >= ring->capacity) ? (index - ring->capacity) : index;
 }
 
 /**
- * @brief Checks if buffer is full
- * 
- * @param Address of circular buffer  
- * @return true if buffer full
- * @return false if buffer is not full
+ * @brief Number of elements between tail and head.
  */
-bool is_buffer_full(BufferType* bufferLog)
+static inline uint16_t ring_count(const RingBuffer *ring, uint16_t head, uint16_t tail)
 {
-   // empty buffer
-   if (bufferLog->head == bufferLog->tail)
+   return (head >= tail) ? (head - tail) : (head + 2U * ring->capacity - tail);
+}
+
+/**
+ * @brief Copies count elements into the ring starting at index, in at most
+ *        two pieces around the end of the storage.
+ */
+static void ring_copy_in(RingBuffer *ring, uint16_t index, const uint8_t *src, uint16_t count)
+{
+   uint16_t slot = ring_slot(ring, index);
+   uint16_t first = ring->capacity - slot;
+
+   if (first > count)
    {
-      return false;
+      first = count;
    }
+   memcpy(ring->storage + (uint32_t)slot * ring->element_size, src,
+          (uint32_t)first * ring->element_size);
+   memcpy(ring->storage, src + (uint32_t)first * ring->element_size,
+          (uint32_t)(count - first) * ring->element_size);
+}
 
-   // head > tail
-   if ((bufferLog->head > bufferLog->tail) &&               //Head is greater than tail 
-       ((bufferLog->head - bufferLog->tail + 1) == BUFFER_SIZE))   //Head is at the last location and tail is at first location of buffer   
+/**
+ * @brief Copies count elements out of the ring starting at index.
+ */
+static void ring_copy_out(const RingBuffer *ring, uint16_t index, uint8_t *dst, uint16_t count)
+{
+   uint16_t slot = ring_slot(ring, index);
+   uint16_t first = ring->capacity - slot;
+
+   if (first > count)
    {
-      return true;
+      first = count;
    }
+   memcpy(dst, ring->storage + (uint32_t)slot * ring->element_size,
+          (uint32_t)first * ring->element_size);
+   memcpy(dst + (uint32_t)first * ring->element_size, ring->storage,
+          (uint32_t)(count - first) * ring->element_size);
+}
+
+/**
+ * @brief Empties the ring buffer.
+ *
+ * Must not race with either side of the buffer.
+ *
+ * @param ring Ring buffer.
+ */
+void ring_reset(RingBuffer *ring)
+{
+   ring->head = 0;
+   ring->tail = 0;
+}
 
-   // tail > head
-   if ((bufferLog->head < bufferLog->tail) &&               //Tail is greater than head
-       ((bufferLog->tail - bufferLog->head - 1) == 0))      //Tail is one location ahead of head
+/**
+ * @brief Appends up to count elements; producer side.
+ *
+ * The elements are published together, so the consumer sees either none
+ * or all of them.
+ *
+ * @param ring     Ring buffer.
+ * @param elements Array of count elements.
+ * @param count    Number of elements to append.
+ * @return uint16_t Number of elements appended, less than count if the
+ *                  buffer filled up.
+ */
+uint16_t ring_push_bulk(RingBuffer *ring, const void *elements, uint16_t count)
+{
+   uint16_t head = ring->head;
+   uint16_t space = ring->capacity - ring_count(ring, head, ring->tail);
+
+   if (count > space)
    {
-      return true;
+      count = space;
+   }
+   if (count == 0)
+   {
+      return 0;
    }
 
-   return false;                                //return false for every other condition
+   ring_copy_in(ring, head, elements, count);
+   BUFFER_BARRIER();                                   // elements stored before they are published
+   ring->head = ring_advance(ring, head, count);
+   return count;
 }
 
 /**
- * @brief Puts character at the head of buffer
- * 
- * @param Address of circular buffer
- * @param Character to be put into circular buffer
- * @return int 
+ * @brief Removes up to count of the oldest elements; consumer side.
+ *
+ * @param ring     Ring buffer.
+ * @param elements Array receiving the elements, oldest first; may be NULL
+ *                 to discard them.
+ * @param count    Maximum number of elements to remove.
+ * @return uint16_t Number of elements removed.
  */
-int write_to_buffer(BufferType* bufferLog, const BME280_Data* c)
+uint16_t ring_pop_bulk(RingBuffer *ring, void *elements, uint16_t count)
 {
-   if (is_buffer_full(bufferLog) == true)
+   uint16_t tail = ring->tail;
+   uint16_t available = ring_count(ring, ring->head, tail);
+
+   if (count > available)
    {
-      return ERROR;
+      count = available;
+   }
+   if (count == 0)
+   {
+      return 0;
    }
-   bufferLog->buffer[bufferLog->head] = *c;             // put value of c into the buffer head
-   bufferLog->head++;                                  //increments head by 1
 
-   if (bufferLog->head == BUFFER_SIZE)                       //when head reaches end of buffer, reset it to intial location
+   BUFFER_BARRIER();                                   // head read before the elements
+   if (elements != NULL)
    {
-      bufferLog->head = 0;
+      ring_copy_out(ring, tail, elements, count);
    }
-   bufferLog->length++;
-   return SUCCESS;
+   BUFFER_BARRIER();                                   // elements copied before the slots are released
+   ring->tail = ring_advance(ring, tail, count);
+   return count;
+}
+
+/**
+ * @brief Appends one element; producer side, may run in an interrupt handler.
+ *
+ * @param ring    Ring buffer.
+ * @param element Element to append.
+ * @return int SUCCESS, or ERROR if the buffer is full
+ */
+int ring_push(RingBuffer *ring, const void *element)
+{
+   return (ring_push_bulk(ring, element, 1) == 1) ? SUCCESS : ERROR;
+}
+
+/**
+ * @brief Removes the oldest element; consumer side.
+ *
+ * @param ring    Ring buffer.
+ * @param element Receives the element.
+ * @return int SUCCESS, or ERROR if the buffer is empty
+ */
+int ring_pop(RingBuffer *ring, void *element)
+{
+   return (ring_pop_bulk(ring, element, 1) == 1) ? SUCCESS : ERROR;
 }
 
 /**
- * @brief Gets character from Buffer Tail
- * 
- * @param Address of circular buffer
- * @param Character to be received from the tail
- * @return int 
+ * @brief Copies an element without removing it; consumer side.
+ *
+ * @param ring    Ring buffer.
+ * @param index   Position counted from the oldest element (0).
+ * @param element Receives the element.
+ * @return int SUCCESS, or ERROR if index is beyond the fill level
  */
-int read_from_buffer(BufferType* bufferLog, BME280_Data* c)
+int ring_peek(const RingBuffer *ring, uint16_t index, void *element)
 {
-   if (is_buffer_empty(bufferLog) == true)
+   uint16_t tail = ring->tail;
+
+   if (index >= ring_count(ring, ring->head, tail))
    {
       return ERROR;
    }
 
-   // put value of buffer tail into c
-   *c = bufferLog->buffer[bufferLog->tail];
-   bufferLog->tail++;
+   BUFFER_BARRIER();
+   ring_copy_out(ring, ring_advance(ring, tail, index), element, 1);
+   return SUCCESS;
+}
 
-   if (bufferLog->tail == BUFFER_SIZE)
+/**
+ * @brief Gives in-place access to a range of elements; consumer side.
+ *
+ * The range [start, start + count), counted from the oldest element, is
+ * described by one span, or two if it wraps around the end of the storage.
+ * Nothing is copied or removed; the spans stay valid until the consumer
+ * pops or discards the elements they cover. count is clipped to the fill
+ * level.
+ *
+ * @param ring  Ring buffer.
+ * @param start Position of the first element, 0 = oldest.
+ * @param count Number of elements.
+ * @param spans Receives the spans, oldest first; unused entries get count 0.
+ * @return uint8_t Number of spans used (0, 1 or 2).
+ */
+uint8_t ring_spans(const RingBuffer *ring, uint16_t start, uint16_t count, RingSpan spans[2])
+{
+   uint16_t tail = ring->tail;
+   uint16_t available = ring_count(ring, ring->head, tail);
+   uint16_t slot, first;
+
+   spans[0] = (RingSpan){ NULL, 0 };
+   spans[1] = (RingSpan){ NULL, 0 };
+   if (start >= available)
    {
-      bufferLog->tail = 0;
+      return 0;
+   }
+   if (count > available - start)
+   {
+      count = available - start;
+   }
+   if (count == 0)
+   {
+      return 0;
    }
-   bufferLog->length--;
 
-   return SUCCESS;
+   BUFFER_BARRIER();                                   // head read before the elements
+   slot = ring_slot(ring, ring_advance(ring, tail, start));
+   first = ring->capacity - slot;
+   if (first >= count)
+   {
+      spans[0] = (RingSpan){ ring->storage + (uint32_t)slot * ring->element_size, count };
+      return 1;
+   }
+
+   spans[0] = (RingSpan){ ring->storage + (uint32_t)slot * ring->element_size, first };
+   spans[1] = (RingSpan){ ring->storage, count - first };
+   return 2;
 }
 
 /**
- * @brief Gets the length of the circular buffer
- * 
- * @return int
+ * @brief Gives in-place access to all elements; consumer side.
+ *
+ * @param ring  Ring buffer.
+ * @param spans Receives the spans, oldest first.
+ * @return uint8_t Number of spans used (0, 1 or 2).
  */
-inline int cbfifo_length(const BufferType* bufferLog)
+uint8_t ring_window(const RingBuffer *ring, RingSpan spans[2])
 {
-   return bufferLog->length;
+   return ring_spans(ring, 0, ring->capacity, spans);
 }
 
+/**
+ * @brief Removes up to count of the oldest elements without copying them.
+ *
+ * @param ring  Ring buffer.
+ * @param count Maximum number of elements to remove.
+ * @return uint16_t Number of elements removed.
+ */
+uint16_t ring_discard(RingBuffer *ring, uint16_t count)
+{
+   return ring_pop_bulk(ring, NULL, count);
+}
+
+/**
+ * @brief Gets the number of elements in the buffer.
+ *
+ * Either side may call it; the result is a lower bound for the consumer
+ * and an upper bound for the producer.
+ *
+ * @param ring Ring buffer.
+ * @return uint16_t Fill level.
+ */
+uint16_t ring_length(const RingBuffer *ring)
+{
+   return ring_count(ring, ring->head, ring->tail);
+}
+
+/**
+ * @brief Gets the number of free slots.
+ *
+ * @param ring Ring buffer.
+ * @return uint16_t capacity - fill level.
+ */
+uint16_t ring_space(const RingBuffer *ring)
+{
+   return ring->capacity - ring_length(ring);
+}
+
+/**
+ * @brief Checks if the buffer is empty.
+ */
+bool ring_is_empty(const RingBuffer *ring)
+{
+   return ring->head == ring->tail;
+}
+
+/**
+ * @brief Checks if the buffer is full.
+ */
+bool ring_is_full(const RingBuffer *ring)
+{
+   return ring_length(ring) == ring->capacity;
+}
@@ -5,55 +5,70 @@
  * @brief	This file contains the forward declarations of the functions of the 
  *          circular buffer operations.
  *
+ * The ring buffer stores elements of any type; element size and capacity
+ * are fixed per instance at compile time with RING_BUFFER_DEFINE(), so
+ * every queue is sized exactly. It is a single-producer/single-consumer
+ * ring: one context (for example an interrupt handler) may push while
+ * another (for example the main loop) pops, without locking. The consumer
+ * can also look at its contents in place through at most two contiguous
+ * spans, without copying or removing anything.
+ *
  * @author  Venetia Furtado
  * @date    12/02/2025
  *
  */
 #include <stdint.h>
-#include "bme280.h"
+#include <stdbool.h>
 
-#define BUFFER_SIZE 100              // Size for circular buffer
+#define RING_BUFFER_MAX_CAPACITY 0x7FFF  // Indices run over 2 x capacity
 
 /**
  * @brief Contains the components of the circular buffer
- * 
+ *
+ * head and tail run over 0 .. 2 x capacity - 1, so a full buffer
+ * (head - tail = capacity) is told apart from an empty one (head = tail)
+ * without a shared length field, for any capacity. head is written only
+ * by the producer and tail only by the consumer.
  */
 typedef struct
 {
-   BME280_Data buffer[BUFFER_SIZE];
-   uint16_t head; // producer
-   uint16_t tail; // consumer
-   uint32_t length;
-} BufferType;
+   uint8_t *storage;          // capacity x element_size bytes
+   uint16_t element_size;
+   uint16_t capacity;         // in elements
+   volatile uint16_t head;    // producer
+   volatile uint16_t tail;    // consumer
+} RingBuffer;
 
 /**
- * @brief Initializes the head and tail of the circular buffer
- * 
- * @param Address of circular buffer
+ * @brief A contiguous run of elements inside a ring buffer's storage.
  */
-void init_buffer_with_default_val(BufferType* bufferLog);
-/**
- * @brief Puts character at the head of buffer
- * 
- * @param Address of circular buffer
- * @param Character to be put into circular buffer
- * @return int 
- */
-int write_to_buffer(BufferType* bufferLog, const BME280_Data* c);
-/**
- * @brief Gets character from Buffer Tail
- * 
- * @param Address of circular buffer
- * @param Character to be received from the tail
- * @return int 
- */
-int read_from_buffer(BufferType* bufferLog, BME280_Data* c);
+typedef struct
+{
+   const void *data;          // First element of the run
+   uint16_t count;            // Number of elements
+} RingSpan;
 
 /**
- * @brief Gets the length of the circular buffer
- * 
- * @return int
+ * @brief Defines a ring buffer named name holding capacity elements of type.
  */
-int cbfifo_length(const BufferType* bufferLog);
+#define RING_BUFFER_DEFINE(name, type, cap)                                   \
+   _Static_assert(((cap) > 0) && ((cap) <= RING_BUFFER_MAX_CAPACITY),         \
+                  "ring buffer capacity out of range");                      \
+   static type name##_storage[cap];                                          \
+   RingBuffer name = { (uint8_t *)name##_storage, sizeof(type), (cap), 0, 0 }
+
+void ring_reset(RingBuffer *ring);
+int ring_push(RingBuffer *ring, const void *element);
+int ring_pop(RingBuffer *ring, void *element);
+uint16_t ring_push_bulk(RingBuffer *ring, const void *elements, uint16_t count);
+uint16_t ring_pop_bulk(RingBuffer *ring, void *elements, uint16_t count);
+int ring_peek(const RingBuffer *ring, uint16_t index, void *element);
+uint8_t ring_spans(const RingBuffer *ring, uint16_t start, uint16_t count, RingSpan spans[2]);
+uint8_t ring_window(const RingBuffer *ring, RingSpan spans[2]);
+uint16_t ring_discard(RingBuffer *ring, uint16_t count);
+uint16_t ring_length(const RingBuffer *ring);
+uint16_t ring_space(const RingBuffer *ring);
+bool ring_is_empty(const RingBuffer *ring);
+bool ring_is_full(const RingBuffer *ring);
 
 #endif
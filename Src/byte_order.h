@@ -0,0 +1,68 @@
+#ifndef __BYTE_ORDER_H
+#define __BYTE_ORDER_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    byte_order.h
+ * @brief   Little-endian packing of integers into byte streams, shared by the
+ *          telemetry and deferred log frame formats.
+ *
+ * The bytes are written one at a time, so the buffers need no alignment and
+ * the result does not depend on the byte order of the host.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+
+/**
+ * @brief Stores a 16-bit value, low byte first.
+ *
+ * @return uint8_t* Position after the value.
+ */
+static inline uint8_t *put16(uint8_t *p, uint16_t v)
+{
+   p[0] = (uint8_t)v;
+   p[1] = (uint8_t)(v >> 8);
+   return p + 2;
+}
+
+/**
+ * @brief Stores a 32-bit value, low byte first.
+ *
+ * @return uint8_t* Position after the value.
+ */
+static inline uint8_t *put32(uint8_t *p, uint32_t v)
+{
+   p = put16(p, (uint16_t)v);
+   return put16(p, (uint16_t)(v >> 16));
+}
+
+/**
+ * @brief Loads a 16-bit value stored by put16().
+ */
+static inline uint16_t get16(const uint8_t *p)
+{
+   return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief Loads a 32-bit value stored by put32().
+ */
+static inline uint32_t get32(const uint8_t *p)
+{
+   return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+#endif
@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    cpu.c
+ * @brief   Cortex-M0 implementation of the core-level services.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stm32f091xc.h>
+#include "cpu.h"
+#include "power.h"
+
+/**
+ * @brief Masks all interrupts.
+ *
+ * @return uint32_t Previous PRIMASK, to be passed to cpu_exit_critical().
+ */
+uint32_t cpu_enter_critical(void)
+{
+   uint32_t masking_state = __get_PRIMASK();
+   __disable_irq();
+   return masking_state;
+}
+
+/**
+ * @brief Restores the interrupt mask saved by cpu_enter_critical().
+ *
+ * @param masking_state Value returned by cpu_enter_critical().
+ */
+void cpu_exit_critical(uint32_t masking_state)
+{
+   __set_PRIMASK(masking_state);
+}
+
+/**
+ * @brief Stops the core clock until an interrupt becomes pending.
+ *
+ * Called with interrupts masked: WFI still wakes on a pending interrupt,
+ * which is then taken once the caller leaves its critical section. An
+ * event posted between the caller's last check and WFI therefore cannot
+ * be missed. power_idle() chooses between SLEEP and STOP.
+ */
+void cpu_sleep(void)
+{
+   power_idle();
+}
@@ -0,0 +1,30 @@
+#ifndef __CPU_H
+#define __CPU_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    cpu.h
+ * @brief   Core-level services used by the hardware-independent modules:
+ *          interrupt masking and sleep.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+
+uint32_t cpu_enter_critical(void);
+void cpu_exit_critical(uint32_t masking_state);
+void cpu_sleep(void);
+
+#endif
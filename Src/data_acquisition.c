@@ -6,78 +6,348 @@
  * @date    12/02/2025
  *
  */
-#include <stm32f091xc.h>
+#define LOG_MODULE LOG_MODULE_ACQUISITION
 #include <stdio.h>
 #include <stdbool.h>
 #include "data_acquisition.h"
 #include "buffer.h"
+#include "statistics.h"
+#include "archive.h"
+#include "flash_log.h"
 #include "utilities.h"
 #include "log.h"
+#include "profiler.h"
+#include "spi.h"
+#include "systick.h"
 
 #define NUM_SAMPLES 60
+#define ACQUISITION_PERIOD_US 1000000 // acquire_data() runs once per SysTick
+#define SUM_CHECK_INTERVAL NUM_SAMPLES // Samples between recomputations of running_sum_temp
 
-BufferType data_buffer;
-double running_sum_temp;
-float avg_temp;
+// Sensors sampled every second; the first one feeds the averaging buffer
+BME280_Dev sensors[] = {
+#ifdef RUN_WITH_SPI
+   BME280_DEV_SPI(SPI_CS_DEFAULT),
+#else
+   BME280_DEV_I2C(BME280_I2C_ADDR_PRIMARY),
+#endif
+#ifdef SECOND_SENSOR
+   BME280_DEV_I2C(BME280_I2C_ADDR_SECONDARY),
+#endif
+};
+#define NUM_SENSORS (sizeof(sensors) / sizeof(sensors[0]))
+
+BME280_FixedData sensor_data[NUM_SENSORS];
+uint8_t sensors_present;  // Bitmask of sensors that passed BME280_Init()
+
+RING_BUFFER_DEFINE(data_buffer, BME280_FixedData, NUM_SAMPLES);  // Averaging window
+int32_t running_sum_temp; // °C x 100, exact: NUM_SAMPLES x 85.00°C fits easily
+int32_t avg_temp;         // °C x 100
+uint16_t samples_since_check;
+uint32_t acquisition_count; // acquire_data() calls since reset, one per second
+uint32_t sum_check_failures;
+
+static uint32_t conversion_us;        // t_measure,max of the active profile
+static uint32_t conversion_start_us;  // get_time_us() at the last trigger
+static uint32_t read_interval;        // Acquisition periods per new sensor result
+static uint32_t periods_since_read;
+
+/**
+ * @brief Triggers the next conversion of a sensor running in forced mode.
+ *
+ * The result is read by the next acquire_data() call, one SysTick later,
+ * long after the longest measurement time, so acquisition never waits for
+ * the sensor and the sensor sleeps between conversions. The one-tick
+ * latency is deliberate: scheduler timers count whole ticks, and in STOP
+ * only the RTC wakeup runs, so there is no earlier wake-up to read it at.
+ */
+static void start_conversion(BME280_Dev *dev)
+{
+   if (dev->config->mode == BME280_MODE_FORCED)
+   {
+      BME280_TriggerForced(dev);
+      conversion_start_us = get_time_us();
+   }
+}
+
+/**
+ * @brief Recomputes the sum of the buffered temperatures from scratch.
+ *
+ * Walks the averaging window in place through its spans.
+ *
+ * @return int32_t Sum of the buffered temperatures in °C x 100.
+ */
+static int32_t window_sum_temp()
+{
+   RingSpan spans[2];
+   uint8_t n = ring_window(&data_buffer, spans);
+   int32_t sum = 0;
+
+   for (uint8_t s = 0; s < n; s++)
+   {
+      const BME280_FixedData *sample = spans[s].data;
+      for (uint16_t i = 0; i < spans[s].count; i++)
+      {
+         sum += sample[i].temperature;
+      }
+   }
+   return sum;
+}
+
+/**
+ * @brief Verifies the running sum against a full recomputation.
+ *
+ * Integer additions and subtractions cannot drift, so a mismatch means
+ * the sum or the buffer was corrupted; it is reported, counted and the
+ * running sum is replaced by the recomputed value.
+ */
+static void check_running_sum()
+{
+   int32_t sum = window_sum_temp();
+
+   if (sum != running_sum_temp)
+   {
+      sum_check_failures++;
+      LOG_EVENT(LOG_RUNNING_SUM_MISMATCH, running_sum_temp, sum);
+      running_sum_temp = sum;
+   }
+}
+
+/**
+ * @brief Appends the means of the minute just archived to the flash log.
+ *
+ * One sample per minute lets the DATALOG region hold over a week.
+ */
+static void log_minute()
+{
+   ArchiveRecord minute;
+   BME280_FixedData mean;
+
+   if (archive_get(ARCHIVE_TIER_MINUTE, 0, &minute))
+   {
+      mean.temperature = minute.channel[STATS_TEMPERATURE].mean;
+      mean.pressure = (uint32_t)minute.channel[STATS_PRESSURE].mean;
+      mean.humidity = (uint32_t)minute.channel[STATS_HUMIDITY].mean;
+      flash_log_add_sample(&mean, acquisition_count);
+   }
+}
 
 /**
  * @brief Initializes the data acquisition subsystem.
  *
- * This function prepares the global data buffer used for storing sensor
- * readings by populating it with predefined default values. It is
- * called before any data collection or processing occurs.
+ * This function initializes every sensor in the sensor table and prepares
+ * the global data buffer used for storing sensor readings by populating it
+ * with predefined default values. It is called before any data collection
+ * or processing occurs.
+ *
+ * @return uint8_t Number of sensors that responded.
  */
-void Init_DataAcquisition()
+uint8_t Init_DataAcquisition()
 {
-   init_buffer_with_default_val(&data_buffer);
+   uint8_t found = 0;
+
+   sensors_present = 0;
+   for (uint8_t i = 0; i < NUM_SENSORS; i++)
+   {
+      if (BME280_Init(&sensors[i]))
+      {
+         sensors_present |= (1U << i);
+         found++;
+      }
+      else
+      {
+         INFO_LOG("BME280 sensor %u not found", i);
+      }
+   }
+
+   ring_reset(&data_buffer);
+   running_sum_temp = 0;
+   avg_temp = 0;
+   samples_since_check = 0;
+   acquisition_count = 0;
+   set_acquisition_profile(ACQUISITION_PROFILE);
+   Init_Statistics();
+   Init_Archive();
+   return found;
 }
 
 /**
  * @brief Acquires a new BME280 sensor sample and updates buffered data.
  *
  * This function reads the latest temperature, pressure, and humidity values
- * from the BME280 sensor and stores the measurement in a circular buffer.
+ * from all BME280 sensors in one pass and stores the measurement of the
+ * first sensor in a circular buffer. Sensors in forced mode are read once
+ * t_measure,max has passed since the conversion triggered by the previous
+ * call, or once their STATUS register reports it complete, and are then
+ * triggered again; with a profile slower than the acquisition period the
+ * sensors are read only every read_interval calls. A sample that is not
+ * fresh is not added to the buffer, so it cannot be counted twice.
  * If the buffer is full, the oldest sample is removed to maintain the fixed
- * size window. The function also maintains a running sum of temperatures,
+ * size window of NUM_SAMPLES. The function also maintains a running sum of temperatures,
  * allowing efficient computation of a moving average without recalculating
- * over the entire buffer.
+ * over the entire buffer, and feeds the rolling statistics windows and the
+ * archive, whose minute means go to the flash log. The sum
+ * is kept in integer centi-degrees, so it is exact, and is checked against a
+ * full recomputation every SUM_CHECK_INTERVAL samples.
  *
- * @param[out] data Pointer to a BME280_Data structure that will be filled
- *                  with the latest sensor measurement.
+ * @param[out] data Pointer to a BME280_FixedData structure that will be filled
+ *                  with the latest measurement of the first sensor; left
+ *                  unchanged when there is none.
+ * @return bool true if data holds a new conversion of the first sensor.
  */
-void acquire_data(BME280_Data* data)
+bool acquire_data(BME280_FixedData* data)
 {
-   BME280_ReadAll(data);
+   uint8_t ready = sensors_present;
+   uint8_t ok;
+   bool settled;
+   PROF_BEGIN(PROF_SCOPE_ACQUIRE);
+
+   acquisition_count++;
+
+   if (++periods_since_read < read_interval)
+   {
+      PROF_END(PROF_SCOPE_ACQUIRE);
+      return false;  // The sensors have no new result yet
+   }
+   periods_since_read = 0;
+
+   // Past t_measure,max a forced conversion is complete without asking
+   settled = (get_time_us() - conversion_start_us) >= conversion_us;
+   for (uint8_t i = 0; i < NUM_SENSORS; i++)
+   {
+      if ((ready & (1U << i)) && (sensors[i].config->mode == BME280_MODE_FORCED) &&
+          !settled && BME280_IsMeasuring(&sensors[i]))
+      {
+         ready &= ~(1U << i);
+      }
+   }
+
+   ok = BME280_ReadSensors(sensors, NUM_SENSORS, ready, sensor_data);
 
-   if (write_to_buffer(&data_buffer, data) == -1)
+   for (uint8_t i = 0; i < NUM_SENSORS; i++)
+   {
+      if (ready & (1U << i))
+      {
+         start_conversion(&sensors[i]);
+      }
+   }
+
+   if (ok != sensors_present)
+   {
+      LOG_EVENT(LOG_SAMPLE_MISSED, ok);
+   }
+   if (!(ok & 1U))
+   {
+      PROF_END(PROF_SCOPE_ACQUIRE);
+      return false;  // No fresh sample from the first sensor
+   }
+   *data = sensor_data[0];
+
+   if (ring_is_full(&data_buffer))
+   {
+      BME280_FixedData old_sample;
+      ring_pop(&data_buffer, &old_sample);
+      running_sum_temp -= old_sample.temperature;
+   }
+
+   if (ring_push(&data_buffer, data) == -1)
    {
       INFO_LOG("Write to buffer failed!!");
    }
 
    running_sum_temp += data->temperature;
+   if (++samples_since_check >= SUM_CHECK_INTERVAL)
+   {
+      samples_since_check = 0;
+      check_running_sum();
+   }
+   avg_temp = running_sum_temp/ring_length(&data_buffer); 
 
-   if(cbfifo_length(&data_buffer) == NUM_SAMPLES)
+   if (statistics_add_sample(data) && archive_add_minute())
    {
-      BME280_Data old_sample;
-      read_from_buffer(&data_buffer, &old_sample);
-      running_sum_temp -= old_sample.temperature;
+      log_minute();
    }
-   avg_temp = running_sum_temp/cbfifo_length(&data_buffer); 
+   PROF_END(PROF_SCOPE_ACQUIRE);
+   return true;
 }
 
 /**
- * @brief Acquires a new BME280 sensor sample and updates the running average.
- *
- * This function reads a temperature/humidity/pressure sample from the BME280
- * sensor, stores it into the circular buffer, and maintains a 60-sample moving
- * average of the temperature. When the buffer reaches its maximum capacity
- * (60 samples), the oldest sample is removed and its contribution is subtracted
- * from the running sum.
+ * @brief Returns the moving average temperature.
  *
- * @param[in] data Pointer to a BME280_Data structure where the newly acquired
- *                 sensor values will be stored.
+ * @return int32_t Average over the buffered samples in °C x 100.
  */
-float get_avg_temp()
+int32_t get_avg_temp()
 {
    return avg_temp;
 }
+
+/**
+ * @brief Returns the number of acquisition periods since reset.
+ *
+ * @return uint32_t Seconds since Init_DataAcquisition().
+ */
+uint32_t get_uptime_s()
+{
+   return acquisition_count;
+}
+
+/**
+ * @brief Returns the number of times the running sum failed its self-check.
+ *
+ * @return uint32_t Mismatches found since reset.
+ */
+uint32_t get_sum_check_failures()
+{
+   return sum_check_failures;
+}
+
+/**
+ * @brief Returns the number of sensors in the sensor table.
+ *
+ * @return uint8_t Number of configured sensors.
+ */
+uint8_t get_sensor_count()
+{
+   return NUM_SENSORS;
+}
+
+/**
+ * @brief Switches all sensors to one of the predefined configurations.
+ *
+ * The acquisition follows the timing of the profile: a forced conversion
+ * older than its t_measure,max is read without polling STATUS, and a
+ * profile whose output data period is longer than the acquisition period
+ * is read only every few periods, so the same conversion is never counted
+ * twice.
+ *
+ * @param[in] profile Entry of bme280_profiles[].
+ * @return bool false if profile is not a valid entry.
+ */
+bool set_acquisition_profile(BME280_Profile profile)
+{
+   const BME280_Config *config;
+   uint32_t period;
+
+   if (profile >= BME280_PROFILE_COUNT)
+   {
+      return false;
+   }
+   config = &bme280_profiles[profile];
+
+   for (uint8_t i = 0; i < NUM_SENSORS; i++)
+   {
+      if (sensors_present & (1U << i))
+      {
+         BME280_SetProfile(&sensors[i], profile);
+         start_conversion(&sensors[i]);
+      }
+   }
+
+   conversion_us = BME280_MeasureTimeUs(config);
+   period = BME280_SamplePeriodUs(config);
+   read_interval = (period + ACQUISITION_PERIOD_US - 1) / ACQUISITION_PERIOD_US;
+   periods_since_read = 0;
+   INFO_LOG("BME280 profile %u: t_measure %lu us, read every %lu s", profile,
+            (unsigned long)conversion_us, (unsigned long)read_interval);
+   return true;
+}
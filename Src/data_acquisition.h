@@ -18,10 +18,20 @@
  * @date    12/02/2025
  *
  */
+#include <stdbool.h>
 #include "bme280.h"
 
-void Init_DataAcquisition();
-void acquire_data(BME280_Data* data);
-float get_avg_temp();
+// Sensor configuration applied at start-up, an entry of bme280_profiles[]
+#ifndef ACQUISITION_PROFILE
+#define ACQUISITION_PROFILE BME280_PROFILE_WEATHER
+#endif
+
+uint8_t Init_DataAcquisition();
+bool acquire_data(BME280_FixedData* data);
+int32_t get_avg_temp();
+uint32_t get_sum_check_failures();
+uint32_t get_uptime_s();
+uint8_t get_sensor_count();
+bool set_acquisition_profile(BME280_Profile profile);
 
  #endif
\ No newline at end of file
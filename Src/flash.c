@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    flash.c
+ * @brief   Flash memory interface (FLASH) driver for the DATALOG region.
+ *
+ * The region is defined by the _sdatalog and _edatalog symbols of
+ * STM32F091RCTX_FLASH.ld, outside the FLASH region the code is linked into.
+ * The flash interface is unlocked only for the duration of each operation.
+ *
+ * The STM32F091 has a single flash bank: while a page erase (up to 40 ms)
+ * or a halfword program (up to 70 µs) is in progress, any fetch from flash,
+ * including an interrupt vector, waits for it to finish.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ * References:
+ * 1. RM0091 Reference manual, section 3 Embedded flash memory
+ */
+#include "flash.h"
+#include "stm32f091xc.h"
+
+extern uint8_t _sdatalog[];
+extern uint8_t _edatalog[];
+
+/**
+ * @brief Unlocks the FLASH_CR register.
+ */
+static void flash_unlock(void)
+{
+   if (FLASH->CR & FLASH_CR_LOCK)
+   {
+      FLASH->KEYR = FLASH_KEY1;
+      FLASH->KEYR = FLASH_KEY2;
+   }
+}
+
+/**
+ * @brief Waits for the current operation and reports its outcome.
+ *
+ * @return bool true if the operation completed without a programming or
+ *              write protection error.
+ */
+static bool flash_wait(void)
+{
+   uint32_t sr;
+
+   while (FLASH->SR & FLASH_SR_BSY)
+      ;
+   sr = FLASH->SR;
+   FLASH->SR = FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR;  // Write 1 to clear
+   return !(sr & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR));
+}
+
+/**
+ * @brief Returns the number of pages in the DATALOG region.
+ */
+uint16_t flash_page_count(void)
+{
+   return (uint16_t)((_edatalog - _sdatalog) / FLASH_LOG_PAGE_SIZE);
+}
+
+/**
+ * @brief Returns the memory-mapped address of a page, for reading.
+ */
+const uint8_t *flash_page_address(uint16_t page)
+{
+   return _sdatalog + (uint32_t)page * FLASH_LOG_PAGE_SIZE;
+}
+
+/**
+ * @brief Erases one page of the DATALOG region.
+ *
+ * @param page Page number within the region.
+ * @return bool false if page is out of range or the erase failed.
+ */
+bool flash_erase_page(uint16_t page)
+{
+   bool ok;
+
+   if (page >= flash_page_count())
+   {
+      return false;
+   }
+
+   flash_unlock();
+   FLASH->CR |= FLASH_CR_PER;
+   FLASH->AR = (uint32_t)flash_page_address(page);
+   FLASH->CR |= FLASH_CR_STRT;
+   ok = flash_wait();
+   FLASH->CR &= ~FLASH_CR_PER;
+   FLASH->CR |= FLASH_CR_LOCK;
+   return ok;
+}
+
+/**
+ * @brief Programs bytes into an erased part of a page, a halfword at a time.
+ *
+ * @param page   Page number within the region.
+ * @param offset Byte offset in the page, even.
+ * @param data   Bytes to program.
+ * @param length Number of bytes, even.
+ * @return bool false on misaligned or out-of-range arguments or if a
+ *              halfword was not erased.
+ */
+bool flash_program(uint16_t page, uint16_t offset, const void *data, uint16_t length)
+{
+   volatile uint16_t *dest;
+   const uint8_t *src = data;
+   bool ok = true;
+
+   if ((page >= flash_page_count()) || (offset & 1) || (length & 1) ||
+       ((uint32_t)offset + length > FLASH_LOG_PAGE_SIZE))
+   {
+      return false;
+   }
+
+   dest = (volatile uint16_t *)(flash_page_address(page) + offset);
+   flash_unlock();
+   FLASH->CR |= FLASH_CR_PG;
+   for (uint16_t i = 0; (i < length) && ok; i += 2)
+   {
+      *dest++ = (uint16_t)(src[i] | (src[i + 1] << 8));
+      ok = flash_wait();
+   }
+   FLASH->CR &= ~FLASH_CR_PG;
+   FLASH->CR |= FLASH_CR_LOCK;
+   return ok;
+}
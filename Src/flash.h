@@ -0,0 +1,37 @@
+#ifndef __FLASH_H
+#define __FLASH_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    flash.h
+ * @brief   Erase and program access to the DATALOG region of the on-chip
+ *          flash reserved by the linker script.
+ *
+ * Pages are numbered from 0 at the start of the region. Erased flash reads
+ * 0xFF, and a halfword can only be programmed once after an erase.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FLASH_LOG_PAGE_SIZE 2048   // STM32F091 flash page
+
+uint16_t flash_page_count(void);
+const uint8_t *flash_page_address(uint16_t page);
+bool flash_erase_page(uint16_t page);
+bool flash_program(uint16_t page, uint16_t offset, const void *data, uint16_t length);
+
+#endif
@@ -0,0 +1,449 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    flash_log.c
+ * @brief   Wear-levelled, append-only sample log in on-chip flash.
+ *
+ * Samples, one per minute from data_acquisition.c, are compressed into
+ * TS_BLOCK_SIZE byte blocks (ts_codec.c) in RAM. Each full block becomes
+ * one record of the log:
+ *
+ *   page:   | sequence (4) | magic (4) | record 0 | ... | record 14 | unused |
+ *   record: | valid (2) | CRC-16 of the block (2) | block (128) |
+ *
+ * Pages are filled in order and the log wraps around the region, so every
+ * page is erased equally often. A page header is programmed when the page
+ * receives its first record, with a sequence number one higher than the
+ * previous page; at boot the page with the highest sequence number is the
+ * one being filled, and only that page is scanned to find the next free
+ * record. A record is programmed block first, then CRC, then the valid
+ * marker, so a record cut short by a reset or a programming error is never
+ * taken as valid. Its slot is no longer erased and stays used; reading and
+ * counting skip slots without the marker.
+ *
+ * Flash is never written from the sampling task: a full block is handed to
+ * the "flash" scheduler task, which programs it after acquisition has
+ * finished. The page the log moves to next is erased by the same task as
+ * soon as the current page is half full, long before it is needed, so the
+ * page erase never delays a sample. The block being filled in RAM, about
+ * 20 minutes of samples, is lost on reset.
+ *
+ * The 64 KB region holds 32 x 15 records of about 20 samples: 8 days at one
+ * sample per minute.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#define LOG_MODULE LOG_MODULE_FLASH
+#include <stdio.h>
+#include <string.h>
+#include "flash_log.h"
+#include "flash.h"
+#include "crc.h"
+#include "scheduler.h"
+#include "log.h"
+
+#define LOG_PAGE_MAGIC    0x474F4C42UL   // "BLOG"
+#define LOG_RECORD_VALID  0xA55A
+
+typedef struct
+{
+   uint32_t sequence;   // Programmed before magic
+   uint32_t magic;
+} LogPageHeader;
+
+typedef struct
+{
+   uint16_t valid;
+   uint16_t crc;
+   uint8_t block[TS_BLOCK_SIZE];
+} LogRecord;
+
+#define RECORDS_PER_PAGE  ((FLASH_LOG_PAGE_SIZE - sizeof(LogPageHeader)) / sizeof(LogRecord))
+#define RECORD_OFFSET(slot) (sizeof(LogPageHeader) + (slot) * sizeof(LogRecord))
+
+static uint16_t num_pages;
+static uint16_t head_page;        // Page being filled
+static uint16_t head_slot;        // Next free record of head_page
+static uint32_t head_sequence;    // Sequence number of head_page, 0 if the log is empty
+static uint16_t pages_used;       // Pages holding a valid header
+static bool next_erased;          // The page after head_page is erased
+
+static uint8_t blocks[2][TS_BLOCK_SIZE];
+static uint8_t active;            // Block being filled
+static bool pending;              // The other block waits for the flash task
+static TsEncoder encoder;
+static uint32_t time_base;        // Log time of the first sample after reset
+static uint8_t task_id = SCHED_NO_TASK;
+
+static uint32_t records_written;
+static uint32_t blocks_dropped;
+static uint32_t flash_errors;
+
+static const LogPageHeader *page_header(uint16_t page)
+{
+   return (const LogPageHeader *)flash_page_address(page);
+}
+
+static const LogRecord *page_record(uint16_t page, uint16_t slot)
+{
+   return (const LogRecord *)(flash_page_address(page) + RECORD_OFFSET(slot));
+}
+
+static bool page_valid(uint16_t page)
+{
+   return page_header(page)->magic == LOG_PAGE_MAGIC;
+}
+
+static bool is_blank(const uint8_t *bytes, uint16_t length)
+{
+   for (uint16_t i = 0; i < length; i++)
+   {
+      if (bytes[i] != 0xFF)
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+static uint16_t next_page(uint16_t page)
+{
+   return (page + 1 < num_pages) ? page + 1 : 0;
+}
+
+static uint16_t previous_page(uint16_t page)
+{
+   return (page != 0) ? page - 1 : num_pages - 1;
+}
+
+/**
+ * @brief Checks whether a record was programmed to the end.
+ */
+static bool record_complete(const LogRecord *record)
+{
+   return record->valid == LOG_RECORD_VALID;
+}
+
+/**
+ * @brief Checks the marker and CRC of a record.
+ */
+static bool record_valid(const LogRecord *record)
+{
+   return record_complete(record) &&
+          (record->crc == crc16(CRC16_INIT, record->block, TS_BLOCK_SIZE));
+}
+
+/**
+ * @brief Returns the number of complete records in the first slots of a page.
+ */
+static uint16_t page_count(uint16_t page, uint16_t slots)
+{
+   uint16_t count = 0;
+
+   for (uint16_t slot = 0; slot < slots; slot++)
+   {
+      if (record_complete(page_record(page, slot)))
+      {
+         count++;
+      }
+   }
+   return count;
+}
+
+/**
+ * @brief Erases the page after head_page, dropping its records.
+ */
+static void erase_next_page(void)
+{
+   uint16_t page = next_page(head_page);
+
+   if (page_valid(page))
+   {
+      pages_used--;
+   }
+   next_erased = flash_erase_page(page);
+   if (!next_erased)
+   {
+      flash_errors++;
+   }
+}
+
+/**
+ * @brief Appends one block to the log, moving to the next page if the
+ *        current one is full.
+ */
+static void write_record(const uint8_t *block)
+{
+   LogRecord record;
+   uint16_t offset;
+
+   if (head_slot >= RECORDS_PER_PAGE)
+   {
+      LogPageHeader header = { head_sequence + 1, LOG_PAGE_MAGIC };
+
+      if (!next_erased)
+      {
+         erase_next_page();
+         if (!next_erased)
+         {
+            blocks_dropped++;
+            return;
+         }
+      }
+      head_page = next_page(head_page);
+      head_sequence++;
+      head_slot = 0;
+      pages_used++;
+      if (!flash_program(head_page, 0, &header, sizeof(header)))
+      {
+         flash_errors++;
+      }
+      next_erased = is_blank(flash_page_address(next_page(head_page)), FLASH_LOG_PAGE_SIZE);
+   }
+
+   record.valid = LOG_RECORD_VALID;
+   record.crc = crc16(CRC16_INIT, block, TS_BLOCK_SIZE);
+   memcpy(record.block, block, TS_BLOCK_SIZE);
+
+   // The slot is used up even if programming fails: it is no longer erased
+   offset = RECORD_OFFSET(head_slot);
+   head_slot++;
+   if (!flash_program(head_page, offset + 4, record.block, TS_BLOCK_SIZE) ||
+       !flash_program(head_page, offset + 2, &record.crc, 2) ||
+       !flash_program(head_page, offset, &record.valid, 2))
+   {
+      flash_errors++;
+      return;
+   }
+   records_written++;
+}
+
+/**
+ * @brief Flash task: writes the pending block and pre-erases the next page.
+ */
+static void flash_log_task(void)
+{
+   if (pending)
+   {
+      write_record(blocks[active ^ 1]);
+      pending = false;
+   }
+
+   if (!next_erased && (head_sequence != 0) && (head_slot >= RECORDS_PER_PAGE / 2))
+   {
+      erase_next_page();
+   }
+}
+
+/**
+ * @brief Returns the time of the last sample in the log, or 0 if it is empty.
+ */
+static uint32_t last_logged_time(void)
+{
+   TsSample sample;
+
+   for (uint16_t slot = head_slot; slot > 0; slot--)
+   {
+      const LogRecord *record = page_record(head_page, slot - 1);
+      uint8_t count = ts_block_count(record->block);
+
+      if (record_valid(record) && (count != 0) && ts_block_read(record->block, count - 1, &sample))
+      {
+         return sample.time_s;
+      }
+   }
+   return 0;
+}
+
+/**
+ * @brief Recovers the log state from flash and registers the flash task.
+ *
+ * Reads the header of every page and scans the records of the newest page
+ * only. Must be called after Init_Scheduler().
+ */
+void Init_FlashLog(void)
+{
+   num_pages = flash_page_count();
+   head_sequence = 0;
+   pages_used = 0;
+
+   for (uint16_t page = 0; page < num_pages; page++)
+   {
+      const LogPageHeader *header = page_header(page);
+      if (header->magic != LOG_PAGE_MAGIC)
+      {
+         continue;
+      }
+      pages_used++;
+      if ((header->sequence != 0xFFFFFFFF) && (header->sequence > head_sequence))
+      {
+         head_sequence = header->sequence;
+         head_page = page;
+      }
+   }
+
+   if (head_sequence == 0)
+   {
+      // Empty log: the first record moves to page 0
+      head_page = num_pages - 1;
+      head_slot = RECORDS_PER_PAGE;
+      time_base = 0;
+   }
+   else
+   {
+      // Records are appended in order; skip anything not erased, even a torn record
+      head_slot = 0;
+      for (uint16_t slot = 0; slot < RECORDS_PER_PAGE; slot++)
+      {
+         if (!is_blank((const uint8_t *)page_record(head_page, slot), sizeof(LogRecord)))
+         {
+            head_slot = slot + 1;
+         }
+      }
+      time_base = last_logged_time() + 1;
+   }
+   next_erased = is_blank(flash_page_address(next_page(head_page)), FLASH_LOG_PAGE_SIZE);
+
+   active = 0;
+   pending = false;
+   ts_encoder_init(&encoder, blocks[active]);
+   task_id = scheduler_add_task("flash", flash_log_task);
+
+   if (head_sequence == 0)
+   {
+      LOG_EVENT(LOG_FLASH_EMPTY, num_pages);
+   }
+   else
+   {
+      LOG_EVENT(LOG_FLASH_RECOVERED, (int32_t)flash_log_count(), head_page, head_slot);
+   }
+}
+
+/**
+ * @brief Adds one sample to the block being filled, handing the block to
+ *        the flash task when it is full.
+ *
+ * If the previous block has not been written yet, the full block is
+ * dropped and counted.
+ *
+ * @param data     Sample.
+ * @param uptime_s Seconds since reset; the log time continues from the
+ *                 last sample logged before the reset.
+ */
+void flash_log_add_sample(const BME280_FixedData *data, uint32_t uptime_s)
+{
+   TsSample sample = { time_base + uptime_s, *data };
+
+   if (ts_encode(&encoder, &sample))
+   {
+      return;
+   }
+
+   if (pending)
+   {
+      blocks_dropped++;
+   }
+   else
+   {
+      pending = true;
+      active ^= 1;
+      scheduler_post(task_id);
+   }
+   ts_encoder_init(&encoder, blocks[active]);
+   ts_encode(&encoder, &sample);
+}
+
+/**
+ * @brief Returns the number of complete records in the log, oldest pages
+ *        included.
+ */
+uint32_t flash_log_count(void)
+{
+   uint32_t count = 0;
+
+   for (uint16_t page = 0; page < num_pages; page++)
+   {
+      if (page == head_page)
+      {
+         count += page_count(page, head_slot);
+      }
+      else if (page_valid(page))
+      {
+         count += page_count(page, RECORDS_PER_PAGE);
+      }
+   }
+   return (head_sequence != 0) ? count : 0;
+}
+
+/**
+ * @brief Copies one block from the log.
+ *
+ * Records that were not programmed to the end are skipped, so ages count
+ * complete records only, as flash_log_count() does.
+ *
+ * @param age   0 for the newest block, 1 for the one before, and so on.
+ * @param[out] block Receives the block, to be decoded with ts_decode().
+ * @return bool false if the log holds fewer blocks or the record is corrupt.
+ */
+bool flash_log_read(uint32_t age, uint8_t block[TS_BLOCK_SIZE])
+{
+   uint16_t page = head_page;
+   uint32_t sequence = head_sequence;
+   uint16_t slot = head_slot;
+   const LogRecord *record;
+
+   if (head_sequence == 0)
+   {
+      return false;
+   }
+
+   while (1)
+   {
+      while (slot > 0)
+      {
+         record = page_record(page, --slot);
+         if (!record_complete(record))
+         {
+            continue;
+         }
+         if (age == 0)
+         {
+            if (!record_valid(record))
+            {
+               return false;
+            }
+            memcpy(block, record->block, TS_BLOCK_SIZE);
+            return true;
+         }
+         age--;
+      }
+
+      page = previous_page(page);
+      sequence--;
+      if ((page == head_page) || !page_valid(page) || (page_header(page)->sequence != sequence))
+      {
+         return false;
+      }
+      slot = RECORDS_PER_PAGE;
+   }
+}
+
+/**
+ * @brief Logs the state of the flash log.
+ */
+void flash_log_report(void)
+{
+   LOG_EVENT(LOG_FLASH_REPORT, (int32_t)flash_log_count(), pages_used, num_pages,
+             (int32_t)records_written, (int32_t)blocks_dropped, (int32_t)flash_errors);
+}
@@ -0,0 +1,35 @@
+#ifndef __FLASH_LOG_H
+#define __FLASH_LOG_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    flash_log.h
+ * @brief   Append-only log of compressed sample blocks in the DATALOG
+ *          flash region, kept across resets.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "bme280.h"
+#include "ts_codec.h"
+
+void Init_FlashLog(void);
+void flash_log_add_sample(const BME280_FixedData *data, uint32_t uptime_s);
+uint32_t flash_log_count(void);
+bool flash_log_read(uint32_t age, uint8_t block[TS_BLOCK_SIZE]);
+void flash_log_report(void);
+
+#endif
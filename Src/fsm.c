@@ -15,11 +15,18 @@
  * It includes functions to initialize the FSM, run it continuously, update
  * states, control LED behavior, and handle state-dependent events and logging.
  *
+ * The FSM runs as tasks of the event scheduler: the sampling task is posted
+ * once per SysTick by a periodic timer, the switch and LED tasks are posted
+ * by the EXTI and TIM7 interrupt handlers, which no longer do the work
+ * themselves. In low-power mode the core may enter STOP between samples
+ * while the state is NORMAL; the other states need TIM7 for fast blinking.
+ *
  * @author  Venetia Furtado
  * @date    11/02/2025
  *
  */
 
+#define LOG_MODULE LOG_MODULE_FSM
 #include "fsm.h"
 #include "log.h"
 #include "switch.h"
@@ -27,16 +34,62 @@
 #include "data_acquisition.h"
 #include "pwm.h"
 #include "systick.h"
+#include "timer.h"
+#include "scheduler.h"
+#include "power.h"
+#include "statistics.h"
+#include "archive.h"
+#include "flash_log.h"
+#include "telemetry.h"
+#include "uart.h"
+#include "profiler.h"
+
+#define SAMPLE_PERIOD_TICKS 1
 
 FSMInfo info;
 
+static uint8_t sample_task_id;
+static uint8_t switch_task_id;
+static uint8_t led_task_id;
+
+static void sample_task(void);
+static void switch_task(void);
+static void led_task(void);
+
+/**
+ * @brief Posts the switch task, called from the EXTI interrupt.
+ */
+static void on_switch_press(void)
+{
+   scheduler_post(switch_task_id);
+}
+
+/**
+ * @brief Posts the LED task, called from the TIM7 interrupt.
+ */
+static void on_led_timer(void)
+{
+   scheduler_post(led_task_id);
+}
+
 /**
  * @brief Initializes the FSM.
- * This function sets the FSM to its default starting state `NORMAL`.
+ * This function sets the FSM to its default starting state `NORMAL`,
+ * registers the FSM tasks with the scheduler, starts the sampling timer
+ * and hooks the switch and TIM7 interrupts. Init_Scheduler() must have
+ * been called before.
  */
 void Init_FSM()
 {
    info.state = NORMAL;
+
+   sample_task_id = scheduler_add_task("sample", sample_task);
+   switch_task_id = scheduler_add_task("switch", switch_task);
+   led_task_id = scheduler_add_task("led", led_task);
+
+   scheduler_start_timer(sample_task_id, SAMPLE_PERIOD_TICKS, SAMPLE_PERIOD_TICKS);
+   switch_set_callback(on_switch_press);
+   TIM7_SetCallback(on_led_timer);
 }
 
 /**
@@ -102,16 +155,35 @@ void blink_LED()
    led_brightness(info.led_brightness);
 }
 
+/**
+ * @brief Logs the console transmit counters.
+ */
+static void console_report(void)
+{
+   UART_Stats stats;
+
+   UART_Get_Stats(&stats);
+   LOG_EVENT(LOG_CONSOLE_REPORT, (int32_t)stats.bytes_queued, (int32_t)stats.bytes_dropped,
+             stats.max_used, UART_TX_BUFFER_SIZE, (int32_t)log_dropped());
+}
+
 /**
  * @brief Executes one iteration of the FSM
  *
  * This function performs the following actions based on the current system state:
- *  - Reads the latest environmental data from the BME280 sensor.
- *  - Updates the FSM state based on sensor readings and user switch input.
+ *  - Reads the latest environmental data from the BME280 sensor. When
+ *    no new conversion was read, nothing is logged or sent and the
+ *    temperature threshold is not evaluated, so a stale sample is never
+ *    reported twice.
+ *  - Updates the FSM state based on sensor readings.
+ *  - With TELEMETRY_BINARY, sends the sample as a telemetry frame in
+ *    place of the NORMAL and EMERGENCY text logs.
  *  - Logs relevant information depending on the state:
  *      - NORMAL: Logs current temperature, pressure, and humidity.
  *      - EMERGENCY: Logs a high-temperature warning.
- *      - USER: Logs the moving average temperature.
+ *      - USER: Logs the moving average temperature, the rolling
+ *        statistics of all channels, the hourly archive, the
+ *        state of the flash log and the console counters.
  *  - Handles state transitions with appropriate logging:
  *      - NORMAL -> USER, NORMAL -> EMERGENCY
  *      - EMERGENCY -> USER, EMERGENCY -> NORMAL
@@ -119,78 +191,136 @@ void blink_LED()
  */
 void FSM()
 {
-   BME280_Data data;
-   acquire_data(&data);
+   BME280_FixedData data;
+   bool fresh;
+   PROF_BEGIN(PROF_SCOPE_FSM);
+
+   fresh = acquire_data(&data);
+#ifdef TELEMETRY_BINARY
+   if (fresh)
+   {
+      telemetry_send(&data, info.state, get_uptime_s());
+   }
+#endif
 
    switch (info.state)
    {
    case NORMAL:
-      INFO_LOG("Read values: Temp %0.2f°C Pressure %0.2fhPa Humidity %0.2f%%",
-               data.temperature,
-               data.pressure,
-               data.humidity);
-
-      if (was_switch_activated() == true)
+      if (!fresh)
       {
-         info.state = USER;
-         STATE_TRANSITION_LOG("State Transition: NORMAL -> USER");
+         break;
       }
-      else if (data.temperature >= EMERGENCY_THRESHOLD)
+#ifndef TELEMETRY_BINARY
+      LOG_EVENT(LOG_READ_VALUES, data.temperature, (int32_t)data.pressure, (int32_t)data.humidity);
+#endif
+
+      if (data.temperature >= EMERGENCY_THRESHOLD_CENTI)
       {
          info.state = EMERGENCY;
-         STATE_TRANSITION_LOG("State Transition: NORMAL -> EMERGENCY");
+         LOG_EVENT(LOG_NORMAL_TO_EMERGENCY);
       }
       break;
    case EMERGENCY:
-      WARNING_LOG("HIGH TEMPERATURE WARNING : %0.2f°C", data.temperature);
-      if (was_switch_activated() == true)
+      if (!fresh)
       {
-         info.state = USER;
-         STATE_TRANSITION_LOG("State Transition: EMERGENCY -> USER");
+         break;
       }
-      else if (data.temperature < EMERGENCY_THRESHOLD)
+#ifndef TELEMETRY_BINARY
+      LOG_EVENT(LOG_HIGH_TEMPERATURE, data.temperature);
+#endif
+      if (data.temperature < EMERGENCY_THRESHOLD_CENTI)
       {
          info.state = NORMAL;
-         STATE_TRANSITION_LOG("State Transition: EMERGENCY -> NORMAL");
+         LOG_EVENT(LOG_EMERGENCY_TO_NORMAL);
       }
       break;
 
    case USER:
-      USER_LOG("Average Temperature = %0.2f°C", get_avg_temp());
+      LOG_EVENT(LOG_AVERAGE_TEMPERATURE, get_avg_temp());
+      statistics_report();
+      archive_report();
+      flash_log_report();
+      console_report();
+      scheduler_report();
+      power_report();
+      profiler_report();
 
-      if (data.temperature >= EMERGENCY_THRESHOLD)
+      if (fresh && (data.temperature >= EMERGENCY_THRESHOLD_CENTI))
       {
          info.state = EMERGENCY;
-         STATE_TRANSITION_LOG("State Transition: USER -> EMERGENCY");
+         LOG_EVENT(LOG_USER_TO_EMERGENCY);
       }
       else
       {
          info.state = NORMAL;
-         STATE_TRANSITION_LOG("State Transition: USER -> NORMAL");
+         LOG_EVENT(LOG_USER_TO_NORMAL);
       }
       break;
    }
+   PROF_END(PROF_SCOPE_FSM);
 }
 
 /**
- * @brief This function implements the main FSM execution loop. It repeatedly
- * checks the system tick counter (from SysTick) and calls `FSM()`
- * whenever a new tick is detected. This ensures the FSM runs at a
- * fixed interval determined by the SysTick timer.
+ * @brief Sampling task, posted once per SysTick by the scheduler timer.
+ *
+ * TIM7 does not count while the core is in STOP, so in low-power mode the
+ * 1 s NORMAL blink is driven from here.
+ */
+static void sample_task(void)
+{
+   FSM();
+
+   if ((power_get_mode() == POWER_MODE_LOW) && (info.state == NORMAL))
+   {
+      blink_LED();
+   }
+   power_allow_stop(info.state == NORMAL);
+}
+
+/**
+ * @brief Switch task, posted by the EXTI interrupt on a press of B1.
+ *
+ * Handles the NORMAL -> USER and EMERGENCY -> USER transitions as soon as
+ * the switch is pressed; the average is reported by the next FSM() run.
+ */
+static void switch_task(void)
+{
+   if (was_switch_activated() == false)
+   {
+      return;
+   }
+
+   if (info.state == NORMAL)
+   {
+      info.state = USER;
+      LOG_EVENT(LOG_NORMAL_TO_USER);
+   }
+   else if (info.state == EMERGENCY)
+   {
+      info.state = USER;
+      LOG_EVENT(LOG_EMERGENCY_TO_USER);
+   }
+   power_allow_stop(false);
+}
+
+/**
+ * @brief LED task, posted by the TIM7 interrupt at the end of each period.
+ */
+static void led_task(void)
+{
+   TIM7_SetPeriod(blink_frequency());
+   blink_LED();
+}
+
+/**
+ * @brief This function implements the main FSM execution loop. It hands
+ * control to the event scheduler, which runs the FSM tasks when they are
+ * posted and keeps the core asleep in between.
  *
  * @note This function never returns and is intended to be the main
  *       control loop of the application.
- * @note Relies on get_current_tick() to track SysTick increments.
  */
 void run_FSM()
 {
-   ticktime_t tick_counter = 0;
-   while (1)
-   {
-      if (tick_counter != get_current_tick())
-      {
-         FSM();
-         tick_counter = get_current_tick();
-      }
-   }
+   run_scheduler();
 }
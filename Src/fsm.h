@@ -25,6 +25,7 @@
 #include <stdint.h>
 
 #define EMERGENCY_THRESHOLD 24
+#define EMERGENCY_THRESHOLD_CENTI (EMERGENCY_THRESHOLD * 100) // °C x 100, as in BME280_FixedData
 
 /**
  * @brief Defines predefined brightness levels for the ULED(LD2).
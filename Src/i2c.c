@@ -13,8 +13,12 @@
  * @brief   I2C1 peripheral initialization and read/write functions for STM32F0.
  *
  * This file provides functions to initialize the I2C1 peripheral and perform
- * blocking read and write operations to I2C slave devices. It is used for
- * communication with sensors such as the BME280.
+ * read and write operations to I2C slave devices. Transfers are described by
+ * I2C_Transfer descriptors, queued, and clocked out by the I2C1 interrupt
+ * handler, so the CPU is free while bytes are on the bus. NACK, bus errors
+ * and timeouts are reported through the descriptor status. Blocking
+ * wrappers are kept for initialization code. It is used for communication
+ * with sensors such as the BME280.
  *
  * @author  Venetia Furtado
  * @date    11/25/2025
@@ -26,6 +30,28 @@
 #include <stm32f091xc.h>
 #include <stdio.h>
 #include "utilities.h"
+#include "systick.h"
+#include "i2c.h"
+
+#define I2C_IRQ_PRIORITY 1
+// SCL low timeout: (TIMEOUTA + 1) * 2048 / 48 MHz = ~25 ms
+#define I2C_TIMEOUTA_25MS 585
+#define I2C_ERROR_FLAGS (I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR | I2C_ISR_TIMEOUT)
+#define I2C_CLEAR_ALL_FLAGS (I2C_ICR_NACKCF | I2C_ICR_STOPCF | I2C_ICR_BERRCF | \
+                             I2C_ICR_ARLOCF | I2C_ICR_OVRCF | I2C_ICR_TIMOUTCF)
+
+static I2C_Transfer *queue[I2C_QUEUE_SIZE];
+static uint8_t queue_head;
+static uint8_t queue_tail;
+static uint8_t queue_count;
+
+static I2C_Transfer *volatile active;   // Transfer currently on the bus
+static I2C_Status active_status;        // Status latched until STOP is seen
+static uint16_t active_index;           // Next data byte to send/receive
+static bool reg_sent;                   // Register address phase done
+static uint32_t transfers_started;      // Tells apart transfers that reuse a descriptor
+static uint32_t watched_transfer;      // transfers_started seen by I2C_Poll()
+static uint32_t watched_since_us;      // get_time_us() when it was first seen
 
 /**
  * @brief Initializes the I2C1 peripheral for communication with the BME280 sensor.
@@ -37,6 +63,7 @@
  *  - Resets I2C1 peripheral.
  *  - Sets timing register for 100 kHz standard mode with 48 MHz system clock.
  *  - Configures CSB (PB12) and SDO (PB14) pins to select I2C interface and address 0x76.
+ *  - Enables the SCL low timeout and the transfer/error interrupts.
  *  - Enables I2C1 peripheral.
  */
 void I2C_Init(void)
@@ -80,51 +107,336 @@ void I2C_Init(void)
    // I2C1 Configuration
    I2C1->CR1 = 0;              // Default configuration, peripheral disabled
    I2C1->CR2 = 0;              // Default configuration, 7 bit addressing
-   
+
+   // Detect a slave holding SCL low instead of waiting forever
+   MODIFY_FIELD(I2C1->TIMEOUTR, I2C_TIMEOUTR_TIMEOUTA, I2C_TIMEOUTA_25MS);
+   MODIFY_FIELD(I2C1->TIMEOUTR, I2C_TIMEOUTR_TIMOUTEN, 1);
+
+   // Transfers are driven from I2C1_IRQHandler()
+   I2C1->CR1 |= I2C_CR1_TXIE | I2C_CR1_RXIE | I2C_CR1_NACKIE |
+                I2C_CR1_STOPIE | I2C_CR1_TCIE | I2C_CR1_ERRIE;
+   NVIC_SetPriority(I2C1_IRQn, I2C_IRQ_PRIORITY);
+   NVIC_ClearPendingIRQ(I2C1_IRQn);
+   NVIC_EnableIRQ(I2C1_IRQn);
+
+   queue_head = 0;
+   queue_tail = 0;
+   queue_count = 0;
+   active = NULL;
+   watched_transfer = transfers_started;
+
    MODIFY_FIELD(I2C1->CR1, I2C_CR1_PE, 1); // Enable peripheral
 }
 
+/**
+ * @brief Issues the START condition for a transfer.
+ *
+ * Writes send the register address followed by the data in one transfer and
+ * let the hardware generate STOP (AUTOEND). Reads send only the register
+ * address with AUTOEND cleared, so that the transfer-complete interrupt can
+ * issue the repeated START in read direction.
+ *
+ * @param[in] xfer Transfer to start.
+ */
+static void I2C_Start_Transfer(I2C_Transfer *xfer)
+{
+   uint32_t tmp = 0;
+
+   active = xfer;
+   active_status = I2C_OK;
+   active_index = 0;
+   reg_sent = false;
+   transfers_started++;
+
+   I2C1->ICR = I2C_CLEAR_ALL_FLAGS;
+
+   MODIFY_FIELD(tmp, I2C_CR2_SADD, xfer->dev_adx << 1);
+   MODIFY_FIELD(tmp, I2C_CR2_RD_WRN, 0);                  // First write addresses
+   if (xfer->read)
+   {
+      MODIFY_FIELD(tmp, I2C_CR2_NBYTES, 1);               // 1 byte: register address
+   }
+   else
+   {
+      MODIFY_FIELD(tmp, I2C_CR2_NBYTES, xfer->data_len + 1); // data bytes + reg. adx.
+      MODIFY_FIELD(tmp, I2C_CR2_AUTOEND, 1);              // STOP after last byte
+   }
+   MODIFY_FIELD(tmp, I2C_CR2_START, 1);
+   I2C1->CR2 = tmp;
+}
+
+/**
+ * @brief Starts the transfer at the head of the queue, if any.
+ *
+ * @note Must be called with interrupts disabled or from I2C1_IRQHandler().
+ */
+static void I2C_Start_Next(void)
+{
+   if ((active == NULL) && (queue_count > 0))
+   {
+      I2C_Start_Transfer(queue[queue_head]);
+   }
+}
+
+/**
+ * @brief Resets I2C1 after an error so that SDA/SCL are released.
+ *
+ * Clearing PE resets the internal state machine and status flags; the
+ * configuration registers (timing, timeout, interrupt enables) are kept.
+ */
+static void I2C_Recover(void)
+{
+   MODIFY_FIELD(I2C1->CR1, I2C_CR1_PE, 0);
+   while (I2C1->CR1 & I2C_CR1_PE)
+      ;
+   MODIFY_FIELD(I2C1->CR1, I2C_CR1_PE, 1);
+}
+
+/**
+ * @brief Completes the active transfer and starts the next queued one.
+ *
+ * @param[in] status Final status reported in the descriptor.
+ * @note Must be called with interrupts disabled or from I2C1_IRQHandler().
+ */
+static void I2C_Finish(I2C_Status status)
+{
+   I2C_Transfer *xfer = active;
+
+   queue_head = (queue_head + 1) % I2C_QUEUE_SIZE;
+   queue_count--;
+   active = NULL;
+
+   xfer->status = status;
+   xfer->done = true;
+   if (xfer->callback != NULL)
+   {
+      xfer->callback(xfer);
+   }
+
+   I2C_Start_Next();
+}
+
+/**
+ * @brief I2C1 event and error interrupt handler.
+ *
+ * Feeds TXDR on TXIS, drains RXDR on RXNE, turns the register address phase
+ * of a read into a repeated START on TC, and completes the transfer on STOPF.
+ * A NACK is latched and reported once the hardware has sent the automatic
+ * STOP. Bus errors, arbitration loss, overrun and SCL timeout abort the
+ * transfer immediately.
+ */
+void I2C1_IRQHandler(void)
+{
+   uint32_t isr = I2C1->ISR;
+   I2C_Transfer *xfer = active;
+   uint32_t tmp;
+
+   if (xfer == NULL)
+   {
+      I2C1->ICR = I2C_CLEAR_ALL_FLAGS; // Nothing in progress, drop stale flags
+      return;
+   }
+
+   if (isr & I2C_ERROR_FLAGS)
+   {
+      I2C1->ICR = I2C_CLEAR_ALL_FLAGS;
+      I2C_Recover();
+      I2C_Finish((isr & I2C_ISR_TIMEOUT) ? I2C_TIMEOUT : I2C_BUS_ERROR);
+      return;
+   }
+
+   if (isr & I2C_ISR_NACKF)
+   {
+      I2C1->ICR = I2C_ICR_NACKCF;
+      active_status = I2C_NACK; // STOP is generated automatically after NACK
+   }
+
+   if (isr & I2C_ISR_TXIS)
+   {
+      if (!reg_sent)
+      {
+         I2C1->TXDR = xfer->reg_adx;
+         reg_sent = true;
+      }
+      else
+      {
+         I2C1->TXDR = xfer->bufp[active_index++];
+      }
+   }
+
+   if (isr & I2C_ISR_RXNE)
+   {
+      xfer->bufp[active_index++] = I2C1->RXDR;
+   }
+
+   if (isr & I2C_ISR_TC)
+   {
+      // -- Send Repeated START, Device Address, Read Command --
+      tmp = I2C1->CR2;
+      MODIFY_FIELD(tmp, I2C_CR2_RD_WRN, 1);              // Then read data
+      MODIFY_FIELD(tmp, I2C_CR2_NBYTES, xfer->data_len); // Data byte count
+      MODIFY_FIELD(tmp, I2C_CR2_AUTOEND, 1);             // STOP after last byte
+      MODIFY_FIELD(tmp, I2C_CR2_START, 1);
+      I2C1->CR2 = tmp;
+   }
+
+   if (isr & I2C_ISR_STOPF)
+   {
+      I2C1->ICR = I2C_ICR_STOPCF;
+      I2C_Finish(active_status);
+   }
+}
+
+/**
+ * @brief Queues a transfer for the interrupt-driven engine.
+ *
+ * The transfer starts immediately if the bus is idle, otherwise it runs after
+ * the transfers already queued. Completion is signalled by `xfer->done`
+ * and, if set, by `xfer->callback` from interrupt context.
+ *
+ * The transfer is programmed without NBYTES reload, so its length must fit
+ * one NBYTES count: 1..I2C_MAX_READ_LEN data bytes for a read, and
+ * 1..I2C_MAX_WRITE_LEN for a write, whose count includes the register
+ * address.
+ *
+ * @param[in,out] xfer Transfer descriptor, owned by the caller until done.
+ * @return I2C_OK if queued, I2C_BUSY if the queue is full, I2C_INVALID if
+ *         the length is out of range.
+ */
+I2C_Status I2C_Submit(I2C_Transfer *xfer)
+{
+   uint16_t max_len = xfer->read ? I2C_MAX_READ_LEN : I2C_MAX_WRITE_LEN;
+   uint32_t masking_state;
+
+   if ((xfer->data_len == 0) || (xfer->data_len > max_len))
+   {
+      return I2C_INVALID;
+   }
+
+   masking_state = __get_PRIMASK();
+   __disable_irq();
+
+   if (queue_count == I2C_QUEUE_SIZE)
+   {
+      __set_PRIMASK(masking_state);
+      return I2C_BUSY;
+   }
+
+   xfer->status = I2C_BUSY;
+   xfer->done = false;
+   queue[queue_tail] = xfer;
+   queue_tail = (queue_tail + 1) % I2C_QUEUE_SIZE;
+   queue_count++;
+   I2C_Start_Next();
+
+   __set_PRIMASK(masking_state);
+   return I2C_OK;
+}
+
+/**
+ * @brief Aborts the active transfer if it has run for I2C_TIMEOUT_US.
+ *
+ * Call periodically from the main loop; I2C_Wait() calls it after every
+ * wake-up.
+ * Covers transfers that never reach STOP, e.g. a wedged peripheral that
+ * raises no further interrupts. The time is read before interrupts are
+ * masked, as get_time_us() requires, and counted from the first poll that
+ * sees the transfer, so a transfer started from the interrupt handler is
+ * timed from its first poll.
+ */
+void I2C_Poll(void)
+{
+   uint32_t now = get_time_us();
+   uint32_t masking_state = __get_PRIMASK();
+   __disable_irq();
+
+   if (active != NULL)
+   {
+      if (watched_transfer != transfers_started)
+      {
+         watched_transfer = transfers_started;
+         watched_since_us = now;
+      }
+      else if ((now - watched_since_us) > I2C_TIMEOUT_US)
+      {
+         I2C_Recover();
+         I2C_Finish(I2C_TIMEOUT);
+      }
+   }
+
+   __set_PRIMASK(masking_state);
+}
+
+/**
+ * @brief Waits until a submitted transfer has completed.
+ *
+ * The core sleeps in WFI between the interrupts of the transfer. done is
+ * checked with interrupts masked, and a pending interrupt still ends WFI,
+ * so a completion between the check and the sleep is not missed. Without
+ * further interrupts, the next SysTick wakes the core and I2C_Poll() ends
+ * the transfer once I2C_TIMEOUT_US has passed.
+ *
+ * @param[in] xfer Previously submitted transfer.
+ * @return Final status of the transfer.
+ */
+I2C_Status I2C_Wait(I2C_Transfer *xfer)
+{
+   while (!xfer->done)
+   {
+      uint32_t masking_state = __get_PRIMASK();
+      __disable_irq();
+      if (!xfer->done)
+      {
+         __WFI();
+      }
+      __set_PRIMASK(masking_state);   // Lets the handler run
+      I2C_Poll();
+   }
+   return xfer->status;
+}
+
+/**
+ * @brief Checks whether the transfer queue is empty.
+ *
+ * @return true if no transfer is queued or in progress.
+ */
+bool I2C_Is_Idle(void)
+{
+   return queue_count == 0;
+}
+
 /**
  * @brief Writes data to a register of an I2C slave device.
  *
  * This function performs a blocking write operation over I2C1 to a
- * specified device and register. It sends the START condition, device
- * address, register address, data bytes, and finally issues a STOP condition.
+ * specified device and register: the START condition, device address,
+ * register address and data bytes are sent by the interrupt handler, which
+ * finally issues a STOP condition. The caller waits for completion.
  *
  * @param[in] dev_adx   7-bit I2C slave device address.
  * @param[in] reg_adx   Register address in the slave device to write to.
  * @param[in] bufp      Pointer to the buffer containing data to be sent.
  * @param[in] data_len  Number of bytes to write from the buffer.
+ * @return I2C_Status   I2C_OK, or the reason the write failed.
  */
-void I2C_WriteReg(uint8_t dev_adx, uint8_t reg_adx, const uint8_t* bufp, uint16_t data_len)
+I2C_Status I2C_WriteReg(uint8_t dev_adx, uint8_t reg_adx, const uint8_t* bufp, uint16_t data_len)
 {
-   uint32_t tmp;
-   // -- Send START, Device Address, Write Command --
-   tmp = 0;
-   MODIFY_FIELD(tmp, I2C_CR2_SADD, dev_adx << 1);
-   MODIFY_FIELD(tmp, I2C_CR2_RD_WRN, 0);            // Write
-   MODIFY_FIELD(tmp, I2C_CR2_NBYTES, data_len + 1); // data bytes + reg. adx.
-   // Set START to start transfer
-   MODIFY_FIELD(tmp, I2C_CR2_START, 1);
-   I2C1->CR2 = tmp;
-   // Wait until START is cleared by hardware
-   while (I2C1->CR2 & I2C_CR2_START)
-      ;
-   // -- Send Register Address --
-   I2C1->TXDR = reg_adx;
-   // Wait until transmitter empty
-   while (!(I2C1->ISR & I2C_ISR_TXE))
-      ;
-   // -- Send Data --
-   while (data_len--)
+   I2C_Transfer xfer = {
+      .dev_adx = dev_adx,
+      .reg_adx = reg_adx,
+      .bufp = (uint8_t *)bufp, // Only read from for writes
+      .data_len = data_len,
+      .read = false,
+      .callback = NULL
+   };
+
+   I2C_Status status = I2C_Submit(&xfer);
+
+   if (status != I2C_OK)
    {
-      I2C1->TXDR = *bufp;
-      bufp++;
-      while (!(I2C1->ISR & I2C_ISR_TXE))
-         ;
+      return status;
    }
-   // -- Send Stop --
-   MODIFY_FIELD(I2C1->CR2, I2C_CR2_STOP, 1);
+   return I2C_Wait(&xfer);
 }
 
 /**
@@ -145,7 +457,8 @@ void test_I2CWrite(void)
  * @brief Reads data from a register of an I2C slave device.
  *
  * This function performs a blocking read operation over I2C1 from a
- * specified device and register. It performs the following steps:
+ * specified device and register. The interrupt handler performs the
+ * following steps:
  *  1. Sends a START condition and writes the device address with write mode.
  *  2. Sends the target register address.
  *  3. Sends a repeated START condition with the device address in read mode.
@@ -156,37 +469,24 @@ void test_I2CWrite(void)
  * @param[in]  reg_adx   Register address in the slave device to read from.
  * @param[out] bufp      Pointer to the buffer to store the read data.
  * @param[in]  data_len  Number of bytes to read.
+ * @return I2C_Status    I2C_OK, or the reason the read failed.
  */
-void I2C_ReadReg(uint8_t dev_adx, uint8_t reg_adx, uint8_t *bufp, uint16_t data_len)
+I2C_Status I2C_ReadReg(uint8_t dev_adx, uint8_t reg_adx, uint8_t *bufp, uint16_t data_len)
 {
-   uint32_t tmp;
-   // -- Send START, Device Address, Write Command --
-   tmp = 0;
-   MODIFY_FIELD(tmp, I2C_CR2_SADD, dev_adx<<1);
-   MODIFY_FIELD(tmp, I2C_CR2_RD_WRN, 0); // First write addresses
-   MODIFY_FIELD(tmp, I2C_CR2_NBYTES, 1); // 1 byte: register address
-   MODIFY_FIELD(tmp, I2C_CR2_START, 1);  // Start transfer
-   I2C1->CR2 = tmp;
-   while (I2C1->CR2 & I2C_CR2_START) // Wait until START ends
-      ;
-   // -- Write Register Address --
-   I2C1->TXDR = reg_adx;
-   while (!(I2C1->ISR & I2C_ISR_TXE)) // Wait until sent
-      ;
-   // -- Send Repeated START, Device Address, Read Command--
-   tmp = I2C1->CR2;
-   MODIFY_FIELD(tmp, I2C_CR2_SADD, dev_adx << 1);
-   MODIFY_FIELD(tmp, I2C_CR2_RD_WRN, 1);        // Then read data
-   MODIFY_FIELD(tmp, I2C_CR2_NBYTES, data_len); // Data byte count
-   MODIFY_FIELD(tmp, I2C_CR2_START, 1);         // Start transfer
-   I2C1->CR2 = tmp;
-   // -- Read Data --
-   while (data_len--)
+   I2C_Transfer xfer = {
+      .dev_adx = dev_adx,
+      .reg_adx = reg_adx,
+      .bufp = bufp,
+      .data_len = data_len,
+      .read = true,
+      .callback = NULL
+   };
+
+   I2C_Status status = I2C_Submit(&xfer);
+
+   if (status != I2C_OK)
    {
-      while (!(I2C1->ISR & I2C_ISR_RXNE)) // Await data rx
-         ;
-      *bufp++ = I2C1->RXDR; // Read RXDR, advance pointer
+      return status;
    }
-   // -- Write Stop --
-   MODIFY_FIELD(I2C1->CR2, I2C_CR2_STOP, 1);
+   return I2C_Wait(&xfer);
 }
@@ -14,7 +14,8 @@
 /**
  * @file    i2c.h
  * @brief	This header declares functions for initializing the I2C1 peripheral
- * and performing blocking read and write operations to I2C slave devices.
+ * and performing read and write operations to I2C slave devices, either
+ * blocking or through the interrupt-driven transfer queue.
  * It is used for communication with the BME280.
  *
  * @author  Venetia Furtado
@@ -22,9 +23,65 @@
  *
  */
 #include <stdint.h>
+#include <stdbool.h>
+
+#define I2C_QUEUE_SIZE     8       // Maximum number of pending transfers
+#define I2C_TIMEOUT_US     50000   // Longer than a 255-byte transfer at 100 kHz (~24 ms)
+#define I2C_MAX_READ_LEN   255     // NBYTES of the data phase, without RELOAD
+#define I2C_MAX_WRITE_LEN  254     // NBYTES counts the register address as well
+
+/**
+ * @brief Result of an I2C transfer.
+ *
+ *  - `I2C_OK`        : Transfer completed and was acknowledged.
+ *  - `I2C_BUSY`      : Transfer still queued/in progress, or queue full on submit.
+ *  - `I2C_NACK`      : Slave did not acknowledge its address or a data byte.
+ *  - `I2C_BUS_ERROR` : Bus error, arbitration loss or overrun.
+ *  - `I2C_TIMEOUT`   : SCL held low too long, or transfer did not finish in time.
+ *  - `I2C_INVALID`   : Length out of range on submit; nothing was queued.
+ */
+typedef enum
+{
+   I2C_OK = 0,
+   I2C_BUSY,
+   I2C_NACK,
+   I2C_BUS_ERROR,
+   I2C_TIMEOUT,
+   I2C_INVALID
+} I2C_Status;
+
+typedef struct I2C_Transfer I2C_Transfer;
+
+/**
+ * @brief Completion callback, invoked from interrupt context once the
+ * transfer has finished (successfully or not).
+ */
+typedef void (*I2C_Callback)(I2C_Transfer *xfer);
+
+/**
+ * @brief Descriptor for one register read or write transfer.
+ *
+ * The caller owns the descriptor and its data buffer; both must stay valid
+ * until `done` is set. `status` and `done` are written by the driver.
+ */
+struct I2C_Transfer
+{
+   uint8_t dev_adx;            // 7-bit slave address
+   uint8_t reg_adx;            // First register to access
+   uint8_t *bufp;              // Data to send, or storage for received data
+   uint16_t data_len;          // 1..I2C_MAX_READ_LEN, 1..I2C_MAX_WRITE_LEN for writes
+   bool read;                  // true: register read, false: register write
+   I2C_Callback callback;      // Optional, may be NULL
+   volatile I2C_Status status;
+   volatile bool done;
+};
 
 void I2C_Init(void);
-void I2C_ReadReg(uint8_t dev_adx, uint8_t reg_adx, uint8_t *bufp, uint16_t data_len);
-void I2C_WriteReg(uint8_t dev_adx, uint8_t reg_adx, const uint8_t *bufp, uint16_t data_len);
+I2C_Status I2C_Submit(I2C_Transfer *xfer);
+I2C_Status I2C_Wait(I2C_Transfer *xfer);
+void I2C_Poll(void);
+bool I2C_Is_Idle(void);
+I2C_Status I2C_ReadReg(uint8_t dev_adx, uint8_t reg_adx, uint8_t *bufp, uint16_t data_len);
+I2C_Status I2C_WriteReg(uint8_t dev_adx, uint8_t reg_adx, const uint8_t *bufp, uint16_t data_len);
 
 #endif
\ No newline at end of file
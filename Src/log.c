@@ -0,0 +1,210 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    log.c
+ * @brief   Output of the messages logged with LOG_EVENT().
+ *
+ * By default a message is printed at the call site by one printf() of its
+ * format, with the colours of the matching log macro. With LOG_DEFERRED the
+ * call site only copies the message id, the argument values and the time
+ * into a RAM ring of LOG_QUEUE_SIZE entries, a few tens of cycles, and
+ * posts the "log" task. That task runs after the tasks registered before
+ * it, so after the sample has been handled, and writes each entry as a
+ * binary frame of at most LOG_FRAME_MAX_SIZE bytes to the console. These
+ * messages are not formatted on the target; Host/log_decode rebuilds the
+ * text from the same message table. Entries that find the ring full are
+ * dropped and counted. The text of the other log macros is sent as text
+ * frames, so the whole log is framed and the image needs no floating-point
+ * printf().
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <stdarg.h>
+#include "log.h"
+#include "buffer.h"
+#include "scheduler.h"
+#include "systick.h"
+
+// Entries waiting for the log task; holds the messages of a USER report
+// logged before its first text frame (transition, average, 9 statistics
+// windows, 25 archive lines, flash and console)
+#define LOG_QUEUE_SIZE  48
+
+#ifdef LOG_DEFERRED
+RING_BUFFER_DEFINE(log_queue, LogFrame, LOG_QUEUE_SIZE);
+
+static uint8_t task_id = SCHED_NO_TASK;
+
+/**
+ * @brief Sends every queued entry as a frame.
+ */
+static void log_flush(void)
+{
+   LogFrame entry;
+   uint8_t frame[LOG_FRAME_MAX_SIZE];
+
+   while (ring_pop(&log_queue, &entry) == 1)
+   {
+      fwrite(frame, 1, log_frame_encode(&entry, frame), stdout);
+   }
+}
+
+/**
+ * @brief Log task: sends the queue.
+ */
+static void log_task(void)
+{
+   log_flush();
+   fflush(stdout);
+}
+
+/**
+ * @brief Formats the text of a log macro and sends it as a text frame;
+ *        called through LOG_PRINT() in LOG_DEFERRED builds.
+ *
+ * The queue is sent first, so messages stay in the order they were logged.
+ * The format must not use floating-point conversions: LOG_DEFERRED images
+ * are linked without printf() float support.
+ *
+ * @param kind   Kind of the calling macro.
+ * @param format printf() format.
+ */
+void log_text(LogKind kind, const char *format, ...)
+{
+   char text[LOG_TEXT_MAX + 1];
+   uint8_t frame[LOG_TEXT_FRAME_MAX_SIZE];
+   va_list args;
+
+   va_start(args, format);
+   vsnprintf(text, sizeof(text), format, args);
+   va_end(args);
+
+   log_flush();
+   fwrite(frame, 1, log_text_frame_encode(kind, time_since_startup(), text, frame), stdout);
+   fflush(stdout);
+}
+#else
+// Arguments as printf() expects them, from the argument list of a message
+#define LOG_FIXED(index, scale) ((double)args[index] / (scale))
+#define LOG_INT(index)          ((long)args[index])
+
+/**
+ * @brief Prints a message with a single printf() of its format and colours.
+ *
+ * @param id   Message id.
+ * @param args Arguments, as many as the message's entry lists.
+ */
+static void log_print(LogMessageId id, const int32_t *args)
+{
+   switch (id)
+   {
+#define LOG_MESSAGE_PRINT(id, kind, format, ...)                      \
+   case id:                                                           \
+      printf(kind##_PREFIX format kind##_SUFFIX, ##__VA_ARGS__);     \
+      break;
+   LOG_MESSAGES(LOG_MESSAGE_PRINT)
+#undef LOG_MESSAGE_PRINT
+   default:
+      break;
+   }
+}
+
+#undef LOG_FIXED
+#undef LOG_INT
+
+#ifdef _NANO_FORMATTED_IO
+// LOG_FIXED arguments are printed with %f, which newlib-nano supports only
+// when _printf_float is linked in. Referenced here rather than with
+// -u _printf_float, so that LOG_DEFERRED images are linked without it.
+extern int _printf_float();
+__attribute__((used)) static int (*const printf_float)() = _printf_float;
+#endif
+#endif
+
+uint8_t log_runtime_level = LOG_LEVEL;
+
+static uint32_t dropped;
+
+/**
+ * @brief Registers the log task in LOG_DEFERRED builds.
+ *
+ * Must be called after Init_Scheduler() and after the tasks that log, so
+ * that the log task runs last.
+ */
+void Init_Log(void)
+{
+#ifdef LOG_DEFERRED
+   ring_reset(&log_queue);
+   task_id = scheduler_add_task("log", log_task);
+#endif
+   dropped = 0;
+}
+
+/**
+ * @brief Logs a message; called through LOG_EVENT(), which has already
+ *        checked the level and module.
+ *
+ * @param id    Message id.
+ * @param nargs Number of arguments, as listed in the message's entry.
+ * @param args  Arguments.
+ */
+void log_event(LogMessageId id, uint8_t nargs, const int32_t *args)
+{
+#ifdef LOG_DEFERRED
+   LogFrame entry = { .id = (uint8_t)id, .nargs = nargs, .time_ms = time_since_startup() };
+
+   for (uint8_t i = 0; i < nargs; i++)
+   {
+      entry.args[i] = args[i];
+   }
+   if (ring_push(&log_queue, &entry) != 1)
+   {
+      dropped++;
+      return;
+   }
+   scheduler_post(task_id);
+#else
+   log_print(id, args);
+#endif
+}
+
+/**
+ * @brief Returns the number of messages dropped because the queue was full.
+ */
+uint32_t log_dropped(void)
+{
+   return dropped;
+}
+
+/**
+ * @brief Sets the run-time log level.
+ *
+ * Messages above this level are skipped at the cost of one comparison.
+ * Messages above LOG_LEVEL are not compiled in and cannot be enabled.
+ *
+ * @param level LOG_LEVEL_NONE to LOG_LEVEL_INFO.
+ */
+void log_set_level(uint8_t level)
+{
+   log_runtime_level = level;
+}
+
+/**
+ * @brief Returns the run-time log level.
+ */
+uint8_t log_get_level(void)
+{
+   return log_runtime_level;
+}
@@ -17,24 +17,213 @@
  * @brief	Logging macros for debugging.
  *
  * This header provides macros for printing log messages
- * to the console when `DEBUG` is defined:
+ * to the console:
  * 
- *  - INFO_LOG(...)    : Prints informational messages.
+ *  - WARNING_LOG(...)          : Faults, level LOG_LEVEL_WARNING.
+ *  - USER_LOG(...)             : Reports asked for with the switch, LOG_LEVEL_USER.
+ *  - STATE_TRANSITION_LOG(...) : FSM state changes, LOG_LEVEL_STATE.
+ *  - INFO_LOG(...)             : Informational messages, LOG_LEVEL_INFO.
+ *
+ * A message is compiled in only if its level is at most LOG_LEVEL and the
+ * bit of the calling file's LOG_MODULE is set in LOG_MODULES; otherwise the
+ * condition is a constant and the call, its format string and its argument
+ * evaluation are removed, even at -O0. LOG_LEVEL defaults to
+ * LOG_LEVEL_INFO in DEBUG builds and LOG_LEVEL_WARNING otherwise; both can
+ * be overridden with -D. A source file selects its module by defining
+ * LOG_MODULE before its first #include. Compiled-in messages are further
+ * filtered at run time by log_set_level().
+ *
+ * Messages listed in log_messages.h are logged with LOG_EVENT(id, args...)
+ * instead. They are printed like the macros above, or, with LOG_DEFERRED,
+ * only queued as an id and integer arguments and shipped later by the
+ * "log" scheduler task as binary frames for Host/log_decode:
+ *
+ *   | 0xA5 0x4C | id | argument count | time_ms (4) | arguments (4 each) | CRC-16 (2) |
+ *
+ * With LOG_DEFERRED the macros above still format their text, which must
+ * use integer conversions only, but send it at once as a text frame, after
+ * the queued messages so that the order is kept:
+ *
+ *   | 0xA5 0x4C | LOG_FRAME_TEXT + kind | length | time_ms (4) | text | CRC-16 (2) |
  *
  * @author  Venetia Furtado
  * @date    10/06/2025
  *
  */
 #include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "log_messages.h"
 
+// Define to queue LOG_EVENT() messages and ship them as binary frames
+//#define LOG_DEFERRED
+
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_WARNING   1
+#define LOG_LEVEL_USER      2
+#define LOG_LEVEL_STATE     3
+#define LOG_LEVEL_INFO      4
+
+#ifndef LOG_LEVEL
 #ifdef DEBUG
-#define INFO_LOG(...) printf("\n\r");printf(__VA_ARGS__); printf("\n\r")
+#define LOG_LEVEL LOG_LEVEL_INFO
 #else
-#define INFO_LOG(...)
+#define LOG_LEVEL LOG_LEVEL_WARNING
+#endif
+#endif
+
+// Modules, one bit each in LOG_MODULES
+#define LOG_MODULE_MAIN         0
+#define LOG_MODULE_FSM          1
+#define LOG_MODULE_ACQUISITION  2
+#define LOG_MODULE_STATISTICS   3
+#define LOG_MODULE_ARCHIVE      4
+#define LOG_MODULE_FLASH        5
+#define LOG_MODULE_SCHEDULER    6
+#define LOG_MODULE_POWER        7
+#define LOG_MODULE_PROFILER     8
+
+#define LOG_MODULE_BIT(module)  (1UL << (module))
+
+#ifndef LOG_MODULES
+#define LOG_MODULES 0xFFFFFFFFUL
+#endif
+
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_MODULE_MAIN
 #endif
 
-#define STATE_TRANSITION_LOG(...) printf("\n\r\033[1;34m" __VA_ARGS__);printf("\033[0m\n\r") //blue
-#define USER_LOG(...) printf("\n\r\033[38;5;214m" __VA_ARGS__);printf("\033[0m\n\r")//orange
-#define WARNING_LOG(...) printf("\n\r\033[1;31m" __VA_ARGS__);printf("\033[0m")   //red
+extern uint8_t log_runtime_level;
+
+/**
+ * @brief true if a message of the given level is logged by this file; a
+ *        compile-time false when level or module is compiled out.
+ */
+#define LOG_ENABLED(level)                                                  \
+   (((level) <= LOG_LEVEL) && ((LOG_MODULES & LOG_MODULE_BIT(LOG_MODULE)) != 0) && \
+    ((level) <= log_runtime_level))
+
+#ifdef LOG_DEFERRED
+#define LOG_PRINT(level, kind, ...)           \
+   do                                         \
+   {                                          \
+      if (LOG_ENABLED(level))                 \
+      {                                       \
+         log_text(kind, __VA_ARGS__);         \
+      }                                       \
+   } while (0)
+#else
+#define LOG_PRINT(level, kind, ...)           \
+   do                                         \
+   {                                          \
+      if (LOG_ENABLED(level))                 \
+      {                                       \
+         printf(kind##_PREFIX __VA_ARGS__);   \
+         printf(kind##_SUFFIX);               \
+      }                                       \
+   } while (0)
+#endif
+
+// Text around a message of each kind, LOG_KIND_<kind>_PREFIX and _SUFFIX
+#define LOG_KIND_INFO_PREFIX          "\n\r"
+#define LOG_KIND_INFO_SUFFIX          "\n\r"
+#define LOG_KIND_TRANSITION_PREFIX    "\n\r\033[1;34m"         //blue
+#define LOG_KIND_TRANSITION_SUFFIX    "\033[0m\n\r"
+#define LOG_KIND_USER_PREFIX          "\n\r\033[38;5;214m"     //orange
+#define LOG_KIND_USER_SUFFIX          "\033[0m\n\r"
+#define LOG_KIND_WARNING_PREFIX       "\n\r\033[1;31m"         //red
+#define LOG_KIND_WARNING_SUFFIX       "\033[0m"
+
+#define INFO_LOG(...) LOG_PRINT(LOG_LEVEL_INFO, LOG_KIND_INFO, __VA_ARGS__)
+#define STATE_TRANSITION_LOG(...) LOG_PRINT(LOG_LEVEL_STATE, LOG_KIND_TRANSITION, __VA_ARGS__)
+#define USER_LOG(...) LOG_PRINT(LOG_LEVEL_USER, LOG_KIND_USER, __VA_ARGS__)
+#define WARNING_LOG(...) LOG_PRINT(LOG_LEVEL_WARNING, LOG_KIND_WARNING, __VA_ARGS__)
+
+typedef enum
+{
+   LOG_KIND_INFO,          // Like INFO_LOG
+   LOG_KIND_WARNING,       // Like WARNING_LOG
+   LOG_KIND_USER,          // Like USER_LOG
+   LOG_KIND_TRANSITION,    // Like STATE_TRANSITION_LOG
+   LOG_KIND_COUNT
+} LogKind;
+
+typedef enum
+{
+#define LOG_MESSAGE_ID(id, kind, format, ...) id,
+   LOG_MESSAGES(LOG_MESSAGE_ID)
+#undef LOG_MESSAGE_ID
+   LOG_MESSAGE_COUNT
+} LogMessageId;
+
+#define LOG_KIND_LEVEL(kind)                                      \
+   (((kind) == LOG_KIND_WARNING) ? LOG_LEVEL_WARNING :            \
+    ((kind) == LOG_KIND_USER) ? LOG_LEVEL_USER :                  \
+    ((kind) == LOG_KIND_TRANSITION) ? LOG_LEVEL_STATE : LOG_LEVEL_INFO)
+
+// LOG_READ_VALUES_LEVEL etc.: level of each message as a compile-time constant,
+// LOG_READ_VALUES_NARGS etc.: number of arguments it takes
+#define LOG_FIXED(index, scale) index
+#define LOG_INT(index)          index
+enum
+{
+#define LOG_MESSAGE_LEVEL(id, kind, format, ...) \
+   id##_LEVEL = LOG_KIND_LEVEL(kind),             \
+   id##_NARGS = sizeof((char[]){ 0, ##__VA_ARGS__ }) - 1,
+   LOG_MESSAGES(LOG_MESSAGE_LEVEL)
+#undef LOG_MESSAGE_LEVEL
+};
+#undef LOG_FIXED
+#undef LOG_INT
+
+#define LOG_MAX_ARGS         6
+#define LOG_TEXT_MAX         80     // Longest text of a text frame
+#define LOG_FRAME_SYNC0      0xA5
+#define LOG_FRAME_SYNC1      0x4C
+#define LOG_FRAME_TEXT       0xF0   // Id of a text frame of LOG_KIND_INFO, other kinds follow
+#define LOG_FRAME_MAX_SIZE   (10 + 4 * LOG_MAX_ARGS)
+#define LOG_TEXT_FRAME_MAX_SIZE (10 + LOG_TEXT_MAX)
+
+/**
+ * @brief A decoded log frame.
+ */
+typedef struct
+{
+   uint8_t id;
+   uint8_t nargs;
+   uint32_t time_ms;
+   int32_t args[LOG_MAX_ARGS];
+} LogFrame;
+
+/**
+ * @brief Logs message id of log_messages.h with the integer arguments its
+ *        entry lists. Main loop only, not from interrupt handlers.
+ */
+#define LOG_EVENT(id, ...)                                                       \
+   do                                                                            \
+   {                                                                             \
+      if (LOG_ENABLED(id##_LEVEL))                                               \
+      {                                                                          \
+         const int32_t log_args_[] = { 0, ##__VA_ARGS__ };                       \
+         _Static_assert(sizeof(log_args_) / sizeof(int32_t) == id##_NARGS + 1,  \
+                        "wrong number of log arguments");                        \
+         log_event(id, sizeof(log_args_) / sizeof(int32_t) - 1, &log_args_[1]);  \
+      }                                                                          \
+   } while (0)
+
+void Init_Log(void);
+void log_set_level(uint8_t level);
+uint8_t log_get_level(void);
+void log_event(LogMessageId id, uint8_t nargs, const int32_t *args);
+void log_text(LogKind kind, const char *format, ...) __attribute__((format(printf, 2, 3)));
+uint32_t log_dropped(void);
+
+LogKind log_message_kind(uint8_t id);
+int log_format(uint8_t id, uint8_t nargs, const int32_t *args, char *out, size_t size);
+uint8_t log_frame_encode(const LogFrame *frame, uint8_t out[LOG_FRAME_MAX_SIZE]);
+uint8_t log_text_frame_encode(LogKind kind, uint32_t time_ms, const char *text,
+                              uint8_t out[LOG_TEXT_FRAME_MAX_SIZE]);
+int log_frame_decode(const uint8_t *in, size_t length, LogFrame *frame, char text[LOG_TEXT_MAX + 1]);
 
 #endif
@@ -0,0 +1,269 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    log_format.c
+ * @brief   Message table of log_messages.h, text formatting of LOG_EVENT()
+ *          messages and the deferred log and text frame formats.
+ *
+ * Used by the firmware to build deferred log frames and by the host tool
+ * Host/log_decode.c to turn them back into text. The firmware never calls
+ * log_format(), so the linker drops it and the format strings with the
+ * rest of the unused sections.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include "log.h"
+#include "crc.h"
+#include "byte_order.h"
+
+#define LOG_FRAME_HEADER  8    // Sync (2), id, argument count, time_ms (4)
+#define LOG_CRC_START     2    // CRC covers id .. arguments
+#define LOG_SPEC_MAX      16   // Longest conversion specification kept
+
+typedef struct
+{
+   const char *format;
+   LogKind kind;
+   int32_t scale[LOG_MAX_ARGS];
+} LogMessage;
+
+// Fixed-point arguments keep their scale, integers have none
+#define LOG_FIXED(index, scale) [index] = (scale)
+#define LOG_INT(index)          [index] = 0
+
+static const LogMessage messages[LOG_MESSAGE_COUNT] = {
+#define LOG_MESSAGE_ENTRY(id, kind, format, ...) \
+   [id] = { format, kind, { __VA_ARGS__ } },
+   LOG_MESSAGES(LOG_MESSAGE_ENTRY)
+#undef LOG_MESSAGE_ENTRY
+};
+
+#define LOG_MESSAGE_ARGS_CHECK(id, kind, format, ...) \
+   _Static_assert(id##_NARGS <= LOG_MAX_ARGS, #id " has too many arguments");
+LOG_MESSAGES(LOG_MESSAGE_ARGS_CHECK)
+#undef LOG_MESSAGE_ARGS_CHECK
+
+#undef LOG_FIXED
+#undef LOG_INT
+
+_Static_assert(LOG_MESSAGE_COUNT <= LOG_FRAME_TEXT, "message ids overlap the text frame ids");
+
+/**
+ * @brief Returns the kind of a message, LOG_KIND_INFO for an unknown id.
+ */
+LogKind log_message_kind(uint8_t id)
+{
+   return (id < LOG_MESSAGE_COUNT) ? messages[id].kind : LOG_KIND_INFO;
+}
+
+/**
+ * @brief Formats a message into text, without the colour codes of its kind.
+ *
+ * Floating-point conversions print their argument divided by the scale of
+ * its position, integer conversions print it as a long, and missing
+ * arguments print as 0.
+ *
+ * @param id    Message id.
+ * @param nargs Number of arguments.
+ * @param args  Arguments.
+ * @param[out] out  Receives the text, always terminated.
+ * @param size  Size of out.
+ * @return int Length of the text, or -1 for an unknown id.
+ */
+int log_format(uint8_t id, uint8_t nargs, const int32_t *args, char *out, size_t size)
+{
+   const char *f;
+   size_t used = 0;
+   uint8_t arg = 0;
+
+   if ((id >= LOG_MESSAGE_COUNT) || (size == 0))
+   {
+      return -1;
+   }
+
+   for (f = messages[id].format; (*f != '\0') && (used + 1 < size); f++)
+   {
+      char spec[LOG_SPEC_MAX + 2];
+      size_t length = 0;
+      int32_t value;
+      int32_t scale;
+      int n;
+
+      if ((*f != '%') || (f[1] == '%'))
+      {
+         out[used++] = *f;
+         f += (*f == '%');
+         continue;
+      }
+
+      // Flags, width and precision are kept, length modifiers dropped
+      spec[length++] = *f++;
+      while ((*f != '\0') && (strchr("-+ #0123456789.", *f) != NULL) && (length < LOG_SPEC_MAX - 1))
+      {
+         spec[length++] = *f++;
+      }
+      while ((*f != '\0') && (strchr("hlLqjzt", *f) != NULL))
+      {
+         f++;
+      }
+      if (*f == '\0')
+      {
+         break;
+      }
+
+      value = (arg < nargs) ? args[arg] : 0;
+      if (strchr("fFeEgG", *f) != NULL)
+      {
+         spec[length++] = *f;
+         spec[length] = '\0';
+         scale = (arg < LOG_MAX_ARGS) ? messages[id].scale[arg] : 0;
+         n = snprintf(&out[used], size - used, spec, (double)value / ((scale != 0) ? scale : 1));
+      }
+      else if (strchr("di", *f) != NULL)
+      {
+         spec[length++] = 'l';
+         spec[length++] = *f;
+         spec[length] = '\0';
+         n = snprintf(&out[used], size - used, spec, (long)value);
+      }
+      else
+      {
+         spec[length++] = 'l';
+         spec[length++] = *f;
+         spec[length] = '\0';
+         n = snprintf(&out[used], size - used, spec, (unsigned long)(uint32_t)value);
+      }
+      arg++;
+
+      if (n > 0)
+      {
+         used += ((size_t)n < size - used) ? (size_t)n : size - used - 1;
+      }
+   }
+
+   out[used] = '\0';
+   return (int)used;
+}
+
+/**
+ * @brief Builds a log frame.
+ *
+ * @param frame Frame contents; at most LOG_MAX_ARGS arguments are sent.
+ * @param[out] out Receives the frame.
+ * @return uint8_t Length of the frame.
+ */
+uint8_t log_frame_encode(const LogFrame *frame, uint8_t out[LOG_FRAME_MAX_SIZE])
+{
+   uint8_t nargs = (frame->nargs < LOG_MAX_ARGS) ? frame->nargs : LOG_MAX_ARGS;
+   uint8_t *p = out;
+
+   *p++ = LOG_FRAME_SYNC0;
+   *p++ = LOG_FRAME_SYNC1;
+   *p++ = frame->id;
+   *p++ = nargs;
+   p = put32(p, frame->time_ms);
+   for (uint8_t i = 0; i < nargs; i++)
+   {
+      p = put32(p, (uint32_t)frame->args[i]);
+   }
+   p = put16(p, crc16(CRC16_INIT, &out[LOG_CRC_START], (uint32_t)(p - out) - LOG_CRC_START));
+   return (uint8_t)(p - out);
+}
+
+/**
+ * @brief Builds a text frame.
+ *
+ * @param kind    Kind of the log macro that produced the text.
+ * @param time_ms Time of the message.
+ * @param text    Text; only the first LOG_TEXT_MAX characters are sent.
+ * @param[out] out Receives the frame.
+ * @return uint8_t Length of the frame.
+ */
+uint8_t log_text_frame_encode(LogKind kind, uint32_t time_ms, const char *text,
+                              uint8_t out[LOG_TEXT_FRAME_MAX_SIZE])
+{
+   size_t length = strlen(text);
+   uint8_t *p = out;
+
+   if (length > LOG_TEXT_MAX)
+   {
+      length = LOG_TEXT_MAX;
+   }
+   *p++ = LOG_FRAME_SYNC0;
+   *p++ = LOG_FRAME_SYNC1;
+   *p++ = (uint8_t)(LOG_FRAME_TEXT + kind);
+   *p++ = (uint8_t)length;
+   p = put32(p, time_ms);
+   memcpy(p, text, length);
+   p += length;
+   p = put16(p, crc16(CRC16_INIT, &out[LOG_CRC_START], (uint32_t)(p - out) - LOG_CRC_START));
+   return (uint8_t)(p - out);
+}
+
+/**
+ * @brief Checks and decodes a log frame or a text frame at the start of a
+ *        buffer.
+ *
+ * @param in     Received bytes.
+ * @param length Number of bytes in.
+ * @param[out] frame Receives the frame contents. For a text frame, id is
+ *                   LOG_FRAME_TEXT + kind and there are no arguments.
+ * @param[out] text  Receives the text of a text frame, terminated.
+ * @return int Length of the frame, 0 if more bytes are needed to tell, or
+ *             -1 if in does not start with a valid frame.
+ */
+int log_frame_decode(const uint8_t *in, size_t length, LogFrame *frame, char text[LOG_TEXT_MAX + 1])
+{
+   bool is_text = (length >= 3) && (in[2] >= LOG_FRAME_TEXT) && (in[2] < LOG_FRAME_TEXT + LOG_KIND_COUNT);
+   size_t size;
+
+   if ((length >= 1 && in[0] != LOG_FRAME_SYNC0) || (length >= 2 && in[1] != LOG_FRAME_SYNC1) ||
+       (length >= 3 && in[2] >= LOG_MESSAGE_COUNT && !is_text) ||
+       (length >= 4 && in[3] > (is_text ? LOG_TEXT_MAX : LOG_MAX_ARGS)))
+   {
+      return -1;
+   }
+   if (length < LOG_FRAME_HEADER)
+   {
+      return 0;
+   }
+
+   size = LOG_FRAME_HEADER + (is_text ? in[3] : 4 * in[3]) + 2;
+   if (length < size)
+   {
+      return 0;
+   }
+   if (get16(&in[size - 2]) != crc16(CRC16_INIT, &in[LOG_CRC_START], (uint32_t)(size - 2 - LOG_CRC_START)))
+   {
+      return -1;
+   }
+
+   frame->id = in[2];
+   frame->time_ms = get32(&in[4]);
+   if (is_text)
+   {
+      frame->nargs = 0;
+      memcpy(text, &in[LOG_FRAME_HEADER], in[3]);
+      text[in[3]] = '\0';
+      return (int)size;
+   }
+   frame->nargs = in[3];
+   for (uint8_t i = 0; i < frame->nargs; i++)
+   {
+      frame->args[i] = (int32_t)get32(&in[LOG_FRAME_HEADER + 4 * i]);
+   }
+   return (int)size;
+}
@@ -0,0 +1,69 @@
+#ifndef _LOG_MESSAGES_H_
+#define _LOG_MESSAGES_H_
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+/**
+ * @file    log_messages.h
+ * @brief   Table of the messages logged with LOG_EVENT().
+ *
+ * Each entry is X(id, kind, format, args...). The firmware expands it into
+ * the LogMessageId enumeration and, when it formats the text itself, into
+ * one printf() call per message; Host/log_decode.c uses the same list,
+ * through log_format(), to turn deferred log frames back into text, so both
+ * always agree. New messages go at the end, so the ids of a deployed image
+ * stay valid.
+ *
+ * Arguments are passed to LOG_EVENT() as int32_t and described, in the
+ * order of the format's conversions, by
+ *  - LOG_FIXED(index, scale): a fixed-point value, printed by a %f, %e or
+ *    %g conversion after division by scale, so the sensor units are logged
+ *    as such;
+ *  - LOG_INT(index): an integer, printed by a %ld, %lu or %lx conversion.
+ * The compiler checks each format against its argument list.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+
+#define LOG_MESSAGES(X) \
+   X(LOG_READ_VALUES,         LOG_KIND_INFO,       "Read values: Temp %0.2f°C Pressure %0.2fhPa Humidity %0.2f%%", \
+     LOG_FIXED(0, 100), LOG_FIXED(1, 25600), LOG_FIXED(2, 1024)) \
+   X(LOG_HIGH_TEMPERATURE,    LOG_KIND_WARNING,    "HIGH TEMPERATURE WARNING : %0.2f°C", LOG_FIXED(0, 100)) \
+   X(LOG_AVERAGE_TEMPERATURE, LOG_KIND_USER,       "Average Temperature = %0.2f°C", LOG_FIXED(0, 100)) \
+   X(LOG_NORMAL_TO_EMERGENCY, LOG_KIND_TRANSITION, "State Transition: NORMAL -> EMERGENCY") \
+   X(LOG_EMERGENCY_TO_NORMAL, LOG_KIND_TRANSITION, "State Transition: EMERGENCY -> NORMAL") \
+   X(LOG_USER_TO_EMERGENCY,   LOG_KIND_TRANSITION, "State Transition: USER -> EMERGENCY") \
+   X(LOG_USER_TO_NORMAL,      LOG_KIND_TRANSITION, "State Transition: USER -> NORMAL") \
+   X(LOG_NORMAL_TO_USER,      LOG_KIND_TRANSITION, "State Transition: NORMAL -> USER") \
+   X(LOG_EMERGENCY_TO_USER,   LOG_KIND_TRANSITION, "State Transition: EMERGENCY -> USER") \
+   X(LOG_SAMPLE_MISSED,       LOG_KIND_INFO,       "BME280 sample missed, mask 0x%lx", LOG_INT(0)) \
+   X(LOG_RUNNING_SUM_MISMATCH, LOG_KIND_WARNING,   "Running sum %ld != recomputed %ld, resynchronized", \
+     LOG_INT(0), LOG_INT(1)) \
+   X(LOG_FLASH_RECOVERED,     LOG_KIND_INFO,       "Flash log: %lu blocks recovered, page %lu record %lu", \
+     LOG_INT(0), LOG_INT(1), LOG_INT(2)) \
+   X(LOG_FLASH_REPORT,        LOG_KIND_USER,       "Flash log: %lu blocks in %lu of %lu pages, %lu written, %lu dropped, %lu errors", \
+     LOG_INT(0), LOG_INT(1), LOG_INT(2), LOG_INT(3), LOG_INT(4), LOG_INT(5)) \
+   X(LOG_CONSOLE_REPORT,      LOG_KIND_USER,       "Console: %lu bytes sent, %lu dropped, buffer peak %lu of %lu, %lu log messages dropped", \
+     LOG_INT(0), LOG_INT(1), LOG_INT(2), LOG_INT(3), LOG_INT(4)) \
+   X(LOG_STATS_TEMPERATURE,   LOG_KIND_USER,       "%2lu min  Temp     mean %0.2f°C min %0.2f max %0.2f sd %0.2f (%lu samples)", \
+     LOG_INT(0), LOG_FIXED(1, 100), LOG_FIXED(2, 100), LOG_FIXED(3, 100), LOG_FIXED(4, 100), LOG_INT(5)) \
+   X(LOG_STATS_PRESSURE,      LOG_KIND_USER,       "%2lu min  Pressure mean %0.2fhPa min %0.2f max %0.2f sd %0.2f (%lu samples)", \
+     LOG_INT(0), LOG_FIXED(1, 25600), LOG_FIXED(2, 25600), LOG_FIXED(3, 25600), LOG_FIXED(4, 25600), LOG_INT(5)) \
+   X(LOG_STATS_HUMIDITY,      LOG_KIND_USER,       "%2lu min  Humidity mean %0.2f%% min %0.2f max %0.2f sd %0.2f (%lu samples)", \
+     LOG_INT(0), LOG_FIXED(1, 1024), LOG_FIXED(2, 1024), LOG_FIXED(3, 1024), LOG_FIXED(4, 1024), LOG_INT(5)) \
+   X(LOG_ARCHIVE_SUMMARY,     LOG_KIND_USER,       "Archive: %lu minute and %lu hour records", LOG_INT(0), LOG_INT(1)) \
+   X(LOG_ARCHIVE_HOUR,        LOG_KIND_USER,       "%2lu h ago: Temp %0.2f/%0.2f/%0.2f°C Pressure %0.2fhPa Humidity %0.2f%%", \
+     LOG_INT(0), LOG_FIXED(1, 100), LOG_FIXED(2, 100), LOG_FIXED(3, 100), LOG_FIXED(4, 25600), LOG_FIXED(5, 1024)) \
+   X(LOG_FLASH_EMPTY,         LOG_KIND_INFO,       "Flash log: empty, %lu pages available", LOG_INT(0))
+
+#endif
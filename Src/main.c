@@ -41,6 +41,11 @@
 #include "pwm.h"
 #include "log.h"
 #include "timer.h"
+#include "scheduler.h"
+#include "power.h"
+#include "flash_log.h"
+#include "profiler.h"
+#include "uart.h"
 
 
 /**
@@ -54,17 +59,26 @@
  */
 int main(void)
 {
+	Init_UART_TX();
+	init_systick();   // Time base of the I2C timeout, before the sensor probe
 #ifdef RUN_WITH_SPI
 	Init_SPI2();
 #else
 	I2C_Init();
 #endif
 	PWM_Init();
-	BME280_Init();
 	Init_switch();
 	Init_DataAcquisition();
+	Init_Scheduler();
+	Init_FlashLog();
 	Init_FSM();
-	init_systick();
+	Init_Log();
+#ifdef LOW_POWER
+	Init_Power(POWER_MODE_LOW);
+#else
+	Init_Power(POWER_MODE_RUN);
+#endif
+	Init_Profiler();
 	Init_TIM7();
 	STATE_TRANSITION_LOG("NORMAL state");
 	run_FSM();
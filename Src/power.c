@@ -0,0 +1,359 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    power.c
+ * @brief   STOP-mode operation with RTC wakeup and power-state accounting.
+ *
+ * In POWER_MODE_LOW the RTC, clocked by the LSI oscillator, runs its wakeup
+ * timer with a period of one tick and replaces SysTick as the tick source.
+ * When the scheduler is idle and STOP is allowed, the core enters STOP with
+ * the regulator in low-power mode. It wakes on the RTC wakeup (EXTI line 20)
+ * or a press of switch B1 (EXTI line 13, configured by Init_switch()),
+ * restores the 48 MHz PLL clock and returns to the scheduler.
+ *
+ * STOP is only entered while no bus transfer is in flight and the FSM does
+ * not need the high-speed timers (TIM7 blink, PWM), see power_allow_stop().
+ * The PWM output holds its current level while the core is in STOP.
+ *
+ * The LSI frequency varies between 30 and 50 kHz from part to part, so it is
+ * measured against the 48 MHz clock with TIM14 input capture at start-up and
+ * the RTC prescalers and wakeup reload are derived from the measurement.
+ *
+ * Time in RUN and SLEEP is measured with SysTick, which stops in STOP; time
+ * in STOP is measured with the RTC calendar.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ * Reference:
+ * 1. RM0091 Reference manual - Chapter 6.3 (Low-power modes)
+ * 2. RM0091 Reference manual - Chapter 26 (RTC)
+ * 3. RM0091 Reference manual - Appendix A.8 (LSI calibration with TIM14)
+ */
+#define LOG_MODULE LOG_MODULE_POWER
+#include <stm32f091xc.h>
+#include <stdio.h>
+#include "utilities.h"
+#include "power.h"
+#include "systick.h"
+#include "i2c.h"
+#include "spi.h"
+#include "uart.h"
+#include "log.h"
+
+#define RTC_IRQ_PRIORITY   1
+#define RTC_WPR_KEY1       0xCA
+#define RTC_WPR_KEY2       0x53
+#define RTC_WPR_LOCK       0xFF
+#define RTC_PREDIV_A       127       // Largest asynchronous prescaler: lowest power
+#define RTC_WUT_DIV        16        // WUCKSEL = 000: RTC clock / 16
+#define LSI_NOMINAL_HZ     40000
+#define LSI_CAPTURE_PSC    8         // IC1PSC = 11: capture every 8th edge
+#define LSI_MEASUREMENTS   8
+#define F_TIM14_CLK        48000000UL
+#define TICK_PERIOD_S      1         // One RTC wakeup per SysTick period
+#define MS_PER_DAY         86400000UL
+
+extern void Set_Clocks_To_48MHz();
+
+static PowerMode power_mode = POWER_MODE_RUN;
+static volatile bool stop_allowed = false;
+static uint32_t lsi_hz = LSI_NOMINAL_HZ;
+static uint32_t rtc_prediv_s;
+static uint64_t state_time_us[POWER_STATE_COUNT];
+static uint32_t run_start;                // systick_count() when the core last woke
+
+/**
+ * @brief Measures the LSI frequency with TIM14 input capture.
+ *
+ * TIM14 channel 1 is remapped to the RTC clock (LSI) and captures every
+ * eighth rising edge while counting at 48 MHz.
+ *
+ * @return uint32_t LSI frequency in Hz.
+ */
+static uint32_t measure_lsi(void)
+{
+   uint32_t total = 0;
+   uint16_t last;
+
+   RCC->APB1ENR |= RCC_APB1ENR_TIM14EN;
+   TIM14->CR1 = 0;
+   TIM14->PSC = 0;
+   TIM14->ARR = 0xFFFF;
+   TIM14->OR = TIM14_OR_TI1_RMP_0;                      // TI1 = RTC clock
+   MODIFY_FIELD(TIM14->CCMR1, TIM_CCMR1_CC1S, 1);       // IC1 mapped on TI1
+   MODIFY_FIELD(TIM14->CCMR1, TIM_CCMR1_IC1PSC, 3);     // Every 8 events
+   TIM14->CCER = TIM_CCER_CC1E;
+   TIM14->CR1 = TIM_CR1_CEN;
+
+   while (!(TIM14->SR & TIM_SR_CC1IF))
+      ;
+   last = TIM14->CCR1;
+   for (uint8_t i = 0; i < LSI_MEASUREMENTS; i++)
+   {
+      while (!(TIM14->SR & TIM_SR_CC1IF))
+         ;
+      uint16_t capture = TIM14->CCR1;
+      total += (uint16_t)(capture - last);
+      last = capture;
+   }
+
+   TIM14->CR1 = 0;
+   TIM14->CCER = 0;
+   TIM14->OR = 0;
+   RCC->APB1ENR &= ~RCC_APB1ENR_TIM14EN;
+
+   return (F_TIM14_CLK * LSI_CAPTURE_PSC * LSI_MEASUREMENTS + total / 2) / total;
+}
+
+/**
+ * @brief Clocks the RTC from the LSI and starts the wakeup timer.
+ *
+ * The calendar runs at 1 Hz with PREDIV_A = 127; the sub-second register
+ * then has a resolution of about 3 ms, enough to account STOP periods.
+ * The wakeup timer fires once per tick and is routed to EXTI line 20.
+ */
+static void Init_RTC(void)
+{
+   // LSI on, backup domain writable, RTC clocked by LSI
+   RCC->CSR |= RCC_CSR_LSION;
+   while (!(RCC->CSR & RCC_CSR_LSIRDY))
+      ;
+   RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+   PWR->CR |= PWR_CR_DBP;
+   RCC->BDCR |= RCC_BDCR_BDRST;
+   RCC->BDCR &= ~RCC_BDCR_BDRST;
+   MODIFY_FIELD(RCC->BDCR, RCC_BDCR_RTCSEL, 2);       // 10: LSI
+   RCC->BDCR |= RCC_BDCR_RTCEN;
+
+   lsi_hz = measure_lsi();
+   rtc_prediv_s = lsi_hz / (RTC_PREDIV_A + 1) - 1;
+
+   RTC->WPR = RTC_WPR_KEY1;
+   RTC->WPR = RTC_WPR_KEY2;
+
+   // Calendar: prescalers, start at 00:00:00, read counters directly
+   RTC->ISR |= RTC_ISR_INIT;
+   while (!(RTC->ISR & RTC_ISR_INITF))
+      ;
+   RTC->PRER = rtc_prediv_s;
+   RTC->PRER |= RTC_PREDIV_A << RTC_PRER_PREDIV_A_Pos;
+   RTC->TR = 0;
+   RTC->CR |= RTC_CR_BYPSHAD;
+   RTC->ISR &= ~RTC_ISR_INIT;
+
+   // Wakeup timer: one interrupt per tick
+   RTC->CR &= ~RTC_CR_WUTE;
+   while (!(RTC->ISR & RTC_ISR_WUTWF))
+      ;
+   RTC->WUTR = (lsi_hz * TICK_PERIOD_S) / RTC_WUT_DIV - 1;
+   MODIFY_FIELD(RTC->CR, RTC_CR_WUCKSEL, 0);
+   RTC->CR |= RTC_CR_WUTIE | RTC_CR_WUTE;
+
+   RTC->WPR = RTC_WPR_LOCK;
+
+   EXTI->IMR |= EXTI_IMR_MR20;
+   EXTI->RTSR |= EXTI_RTSR_TR20;
+   NVIC_SetPriority(RTC_IRQn, RTC_IRQ_PRIORITY);
+   NVIC_ClearPendingIRQ(RTC_IRQn);
+   NVIC_EnableIRQ(RTC_IRQn);
+}
+
+/**
+ * @brief Initializes the power management.
+ *
+ * In POWER_MODE_LOW the RTC wakeup timer is started and takes over the
+ * tick from SysTick. Must be called after init_systick().
+ *
+ * @param mode Operating mode.
+ */
+void Init_Power(PowerMode mode)
+{
+   power_mode = mode;
+   stop_allowed = false;
+   for (uint8_t i = 0; i < POWER_STATE_COUNT; i++)
+   {
+      state_time_us[i] = 0;
+   }
+
+   if (mode == POWER_MODE_LOW)
+   {
+#ifdef DEBUG
+      // Keep the debugger connected while the core is in STOP
+      RCC->APB2ENR |= RCC_APB2ENR_DBGMCUEN;
+      DBGMCU->CR |= DBGMCU_CR_DBG_STOP;
+#endif
+      Init_RTC();
+      set_tick_source(TICK_SOURCE_EXTERNAL);
+      INFO_LOG("Low-power mode, LSI %lu Hz", (unsigned long)lsi_hz);
+   }
+
+   run_start = systick_count();
+}
+
+/**
+ * @brief Returns the operating mode selected by Init_Power().
+ */
+PowerMode power_get_mode(void)
+{
+   return power_mode;
+}
+
+/**
+ * @brief Allows or forbids STOP when the scheduler is idle.
+ *
+ * STOP freezes all high-speed clocks, including TIM7 and the PWM timer,
+ * so it must be forbidden while those are needed.
+ *
+ * @param allow true to allow STOP (only effective in POWER_MODE_LOW).
+ */
+void power_allow_stop(bool allow)
+{
+   stop_allowed = allow;
+}
+
+/**
+ * @brief RTC time of day in milliseconds.
+ *
+ * With BYPSHAD set the counters are read directly, so SSR and TR are read
+ * until two consecutive reads agree.
+ */
+static uint32_t rtc_time_ms(void)
+{
+   uint32_t ssr, tr;
+
+   do
+   {
+      ssr = RTC->SSR;
+      tr = RTC->TR;
+   } while ((ssr != RTC->SSR) || (tr != RTC->TR));
+
+   uint32_t hours = ((tr >> 20) & 0x3) * 10 + ((tr >> 16) & 0xF);
+   uint32_t minutes = ((tr >> 12) & 0x7) * 10 + ((tr >> 8) & 0xF);
+   uint32_t seconds = ((tr >> 4) & 0x7) * 10 + (tr & 0xF);
+   uint32_t sub_ms = ((rtc_prediv_s - ssr) * 1000) / (rtc_prediv_s + 1);
+
+   return ((hours * 60 + minutes) * 60 + seconds) * 1000 + sub_ms;
+}
+
+/**
+ * @brief Checks whether STOP can be entered now.
+ *
+ * Bus transfers and the console would be cut off by the clock stop.
+ */
+static bool can_stop(void)
+{
+   return (power_mode == POWER_MODE_LOW) && stop_allowed &&
+          I2C_Is_Idle() && !SPI_DMA_Is_Busy() && UART_TX_Is_Idle();
+}
+
+/**
+ * @brief Enters STOP until the next wakeup event and restores the clocks.
+ */
+static void enter_stop(void)
+{
+   uint32_t start_ms = rtc_time_ms();
+
+   PWR->CR = (PWR->CR & ~PWR_CR_PDDS) | PWR_CR_LPDS;   // STOP, low-power regulator
+   SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+   __DSB();
+   __WFI();
+   SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+   // STOP exits on the 8 MHz HSI; bring the PLL back
+   Set_Clocks_To_48MHz();
+
+   state_time_us[POWER_STATE_STOP] += (uint64_t)((rtc_time_ms() + MS_PER_DAY - start_ms) % MS_PER_DAY) * 1000;
+}
+
+/**
+ * @brief Idles the core in the deepest allowed state until an interrupt.
+ *
+ * Called by the scheduler with interrupts masked; the interrupt that ends
+ * the idle period is taken when the caller unmasks them.
+ */
+void power_idle(void)
+{
+   state_time_us[POWER_STATE_RUN] += systick_elapsed_us(run_start);
+
+   if (can_stop())
+   {
+      enter_stop();
+   }
+   else
+   {
+      uint32_t start = systick_count();
+      __DSB();
+      __WFI();
+      state_time_us[POWER_STATE_SLEEP] += systick_elapsed_us(start);
+   }
+
+   run_start = systick_count();
+}
+
+/**
+ * @brief Copies the time spent in each power state.
+ *
+ * @param[out] times_us Time per PowerState in µs since Init_Power().
+ */
+void power_get_times(uint64_t times_us[POWER_STATE_COUNT])
+{
+   uint32_t masking_state = __get_PRIMASK();
+   __disable_irq();
+   for (uint8_t i = 0; i < POWER_STATE_COUNT; i++)
+   {
+      times_us[i] = state_time_us[i];
+   }
+   __set_PRIMASK(masking_state);
+}
+
+/**
+ * @brief RTC wakeup interrupt: advances the tick while in POWER_MODE_LOW.
+ */
+void RTC_IRQHandler(void)
+{
+   if (RTC->ISR & RTC_ISR_WUTF)
+   {
+      RTC->ISR &= ~RTC_ISR_WUTF;
+      EXTI->PR = EXTI_PR_PR20;
+      external_tick();
+   }
+}
+
+/**
+ * @brief Logs the time spent in each power state, as part of the USER
+ *        report. Compiled empty when LOG_LEVEL excludes USER_LOG.
+ */
+void power_report(void)
+{
+#if LOG_LEVEL >= LOG_LEVEL_USER
+   static const char *const names[POWER_STATE_COUNT] = { "RUN", "SLEEP", "STOP" };
+   uint64_t times_us[POWER_STATE_COUNT];
+   uint64_t total_us = 0;
+
+   power_get_times(times_us);
+   for (uint8_t i = 0; i < POWER_STATE_COUNT; i++)
+   {
+      total_us += times_us[i];
+   }
+   if (total_us == 0)
+   {
+      return;
+   }
+
+   for (uint8_t i = 0; i < POWER_STATE_COUNT; i++)
+   {
+      uint32_t permille = (uint32_t)((times_us[i] * 1000) / total_us);
+      USER_LOG("  %-5s %lu ms (%lu.%lu%%)", names[i], (unsigned long)(times_us[i] / 1000),
+               (unsigned long)(permille / 10), (unsigned long)(permille % 10));
+   }
+#endif
+}
@@ -0,0 +1,57 @@
+#ifndef __POWER_H
+#define __POWER_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    power.h
+ * @brief   Low-power operation: STOP mode between samples with RTC wakeup,
+ *          and accounting of the time spent in each power state.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Operating modes selected at initialization.
+ *  - `POWER_MODE_RUN` : SysTick drives the tick, idle time is spent in SLEEP.
+ *  - `POWER_MODE_LOW` : The RTC wakeup timer drives the tick and idle time
+ *                       is spent in STOP whenever it is allowed.
+ */
+typedef enum
+{
+   POWER_MODE_RUN,
+   POWER_MODE_LOW
+} PowerMode;
+
+/**
+ * @brief States the time accounting distinguishes.
+ */
+typedef enum
+{
+   POWER_STATE_RUN,     // Core executing
+   POWER_STATE_SLEEP,   // WFI, clocks and peripherals running
+   POWER_STATE_STOP,    // STOP, all clocks but LSI stopped
+   POWER_STATE_COUNT
+} PowerState;
+
+void Init_Power(PowerMode mode);
+PowerMode power_get_mode(void);
+void power_allow_stop(bool allow);
+void power_idle(void);
+void power_get_times(uint64_t times_us[POWER_STATE_COUNT]);
+void power_report(void);
+
+#endif
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    profiler.c
+ * @brief   Per-scope cycle statistics for PROF_BEGIN/PROF_END.
+ *
+ * The Cortex-M0 has no DWT cycle counter, so time is read from TIM14
+ * running at the core clock and extended to 32 bits in software
+ * (TIM14_GetCount()). A reading costs a function call, a critical section
+ * and two peripheral reads, about 30 cycles; the minimum of an empty scope,
+ * measured by Init_Profiler(), is subtracted from every duration. Scopes
+ * must be shorter than the 89 s counter period.
+ *
+ * Scopes can be recorded from interrupt handlers: each update of the
+ * statistics table is a short critical section.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#define LOG_MODULE LOG_MODULE_PROFILER
+#include <stdio.h>
+#include "profiler.h"
+#include "timer.h"
+#include "cpu.h"
+#include "log.h"
+
+#define CALIBRATION_RUNS 8
+
+#if defined(PROFILE) && LOG_LEVEL >= LOG_LEVEL_USER
+static const char *const scope_names[PROF_SCOPE_COUNT] = {
+   [PROF_SCOPE_BME280_READ] = "read",
+   [PROF_SCOPE_ACQUIRE] = "acquire",
+   [PROF_SCOPE_FSM] = "fsm",
+   [PROF_SCOPE_TIM7_IRQ] = "tim7_irq",
+};
+#endif
+
+static ProfStats stats[PROF_SCOPE_COUNT];
+static uint32_t overhead;   // Cycles of an empty PROF_BEGIN/PROF_END pair
+
+/**
+ * @brief Starts the cycle counter and measures the cost of a reading.
+ *
+ * Does nothing without PROFILE. Must be called after Init_Power(), which
+ * uses TIM14 for its LSI calibration.
+ */
+void Init_Profiler(void)
+{
+#ifdef PROFILE
+   Init_TIM14_Counter();
+
+   overhead = UINT32_MAX;
+   for (uint8_t i = 0; i < CALIBRATION_RUNS; i++)
+   {
+      uint32_t start = profiler_now();
+      uint32_t cycles = profiler_now() - start;
+
+      if (cycles < overhead)
+      {
+         overhead = cycles;
+      }
+   }
+   profiler_reset();
+#endif
+}
+
+/**
+ * @brief Returns the current cycle count; used by PROF_BEGIN().
+ */
+uint32_t profiler_now(void)
+{
+   return TIM14_GetCount();
+}
+
+/**
+ * @brief Adds one run of a scope to its statistics; used by PROF_END().
+ *
+ * @param scope Scope.
+ * @param start Cycle count at PROF_BEGIN().
+ */
+void profiler_record(ProfScope scope, uint32_t start)
+{
+   uint32_t cycles = profiler_now() - start;
+   uint32_t masking_state;
+   ProfStats *s;
+
+   if (scope >= PROF_SCOPE_COUNT)
+   {
+      return;
+   }
+   cycles = (cycles > overhead) ? cycles - overhead : 0;
+
+   masking_state = cpu_enter_critical();
+   s = &stats[scope];
+   if ((s->count == 0) || (cycles < s->min))
+   {
+      s->min = cycles;
+   }
+   if (cycles > s->max)
+   {
+      s->max = cycles;
+   }
+   s->total += cycles;
+   s->count++;
+   cpu_exit_critical(masking_state);
+}
+
+/**
+ * @brief Copies the statistics of one scope.
+ *
+ * @param scope Scope.
+ * @param[out] out Receives the statistics.
+ * @return bool false if the scope has not run since the last reset.
+ */
+bool profiler_get(ProfScope scope, ProfStats *out)
+{
+   uint32_t masking_state;
+
+   if (scope >= PROF_SCOPE_COUNT)
+   {
+      return false;
+   }
+   masking_state = cpu_enter_critical();
+   *out = stats[scope];
+   cpu_exit_critical(masking_state);
+   return out->count != 0;
+}
+
+/**
+ * @brief Clears the statistics of all scopes, e.g. before and after an
+ *        optimisation is switched on.
+ */
+void profiler_reset(void)
+{
+   uint32_t masking_state = cpu_enter_critical();
+
+   for (uint8_t i = 0; i < PROF_SCOPE_COUNT; i++)
+   {
+      stats[i] = (ProfStats){ 0 };
+   }
+   cpu_exit_critical(masking_state);
+}
+
+/**
+ * @brief Logs the count and the minimum, mean and maximum duration of
+ *        every scope that has run, in cycles and microseconds. Compiled
+ *        empty without PROFILE or when USER_LOG() is filtered out.
+ */
+void profiler_report(void)
+{
+#if defined(PROFILE) && LOG_LEVEL >= LOG_LEVEL_USER
+   bool header = false;
+
+   for (uint8_t i = 0; i < PROF_SCOPE_COUNT; i++)
+   {
+      ProfStats s;
+      uint32_t mean;
+
+      if (!profiler_get((ProfScope)i, &s))
+      {
+         continue;
+      }
+      if (!header)
+      {
+         USER_LOG("Profile (cycles / us), %lu cycles of overhead removed", (unsigned long)overhead);
+         header = true;
+      }
+      mean = (uint32_t)(s.total / s.count);
+      USER_LOG("  %-9s runs %lu min %lu / %lu max %lu / %lu mean %lu / %lu", scope_names[i],
+               (unsigned long)s.count,
+               (unsigned long)s.min, (unsigned long)(s.min / (TIM14_COUNTER_HZ / 1000000)),
+               (unsigned long)s.max, (unsigned long)(s.max / (TIM14_COUNTER_HZ / 1000000)),
+               (unsigned long)mean, (unsigned long)(mean / (TIM14_COUNTER_HZ / 1000000)));
+   }
+#endif
+}
@@ -0,0 +1,73 @@
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    profiler.h
+ * @brief   Cycle-count profiling of code scopes with the TIM14 counter.
+ *
+ * A scope is timed by bracketing it with PROF_BEGIN(scope) and
+ * PROF_END(scope) in the same block:
+ *
+ *    PROF_BEGIN(PROF_SCOPE_FSM);
+ *    ...
+ *    PROF_END(PROF_SCOPE_FSM);
+ *
+ * Without PROFILE both macros expand to nothing, and TIM14 is left alone.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+// Define to time the PROF_BEGIN/PROF_END scopes
+//#define PROFILE
+
+typedef enum
+{
+   PROF_SCOPE_BME280_READ,       // BME280_ReadSensors()
+   PROF_SCOPE_ACQUIRE,           // acquire_data()
+   PROF_SCOPE_FSM,               // FSM()
+   PROF_SCOPE_TIM7_IRQ,          // TIM7_IRQHandler()
+   PROF_SCOPE_COUNT
+} ProfScope;
+
+/**
+ * @brief Durations of one scope, in core clock cycles.
+ */
+typedef struct
+{
+   uint32_t count;
+   uint32_t min;
+   uint32_t max;
+   uint64_t total;   // Mean = total / count
+} ProfStats;
+
+#ifdef PROFILE
+#define PROF_BEGIN(scope) uint32_t prof_start_##scope = profiler_now()
+#define PROF_END(scope)   profiler_record((scope), prof_start_##scope)
+#else
+#define PROF_BEGIN(scope)
+#define PROF_END(scope)
+#endif
+
+void Init_Profiler(void);
+uint32_t profiler_now(void);
+void profiler_record(ProfScope scope, uint32_t start);
+bool profiler_get(ProfScope scope, ProfStats *stats);
+void profiler_reset(void);
+void profiler_report(void);
+
+#endif
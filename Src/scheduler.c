@@ -0,0 +1,348 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    scheduler.c
+ * @brief   Cooperative event scheduler.
+ *
+ * Work is organized as run-to-completion tasks. A task runs when it has been
+ * posted, either by an interrupt handler that defers its work through
+ * scheduler_post(), or by an entry of the timer-event queue expiring.
+ * Timers count SysTick ticks and are kept sorted by deadline, so only the
+ * head of the queue has to be checked on each pass. When nothing is pending
+ * the core sleeps in WFI until the next interrupt.
+ *
+ * Every task invocation is timed with get_time_us(), as is every sleep, so
+ * the fraction of time the CPU is awake can be reported.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#define LOG_MODULE LOG_MODULE_SCHEDULER
+#include <stdio.h>
+#include "scheduler.h"
+#include "systick.h"
+#include "cpu.h"
+#include "log.h"
+
+typedef struct
+{
+   ticktime_t deadline;
+   uint32_t period;     // 0 for a one-shot timer
+   uint8_t task_id;
+} SchedulerTimer;
+
+static SchedulerTask tasks[SCHED_MAX_TASKS];
+static uint8_t num_tasks;
+static volatile uint32_t pending;   // Bit i set: tasks[i] has been posted
+
+static SchedulerTimer timers[SCHED_MAX_TIMERS];  // Sorted by deadline
+static uint8_t num_timers;
+
+static SchedulerStats stats;
+
+/**
+ * @brief Clears all tasks, timers and statistics.
+ */
+void Init_Scheduler(void)
+{
+   num_tasks = 0;
+   num_timers = 0;
+   pending = 0;
+   stats = (SchedulerStats){0};
+}
+
+/**
+ * @brief Registers a task.
+ *
+ * Tasks posted in the same pass run in the order they were added.
+ *
+ * @param name     Name used by scheduler_report().
+ * @param function Function run each time the task is posted.
+ * @return uint8_t Task id, or SCHED_NO_TASK if the task table is full.
+ */
+uint8_t scheduler_add_task(const char *name, TaskFunction function)
+{
+   if (num_tasks >= SCHED_MAX_TASKS)
+   {
+      return SCHED_NO_TASK;
+   }
+
+   tasks[num_tasks] = (SchedulerTask){ .name = name, .function = function };
+   return num_tasks++;
+}
+
+/**
+ * @brief Marks a task as ready to run.
+ *
+ * Safe to call from interrupt handlers; posting a task that is already
+ * pending has no further effect.
+ *
+ * @param task_id Id returned by scheduler_add_task().
+ */
+void scheduler_post(uint8_t task_id)
+{
+   if (task_id < num_tasks)
+   {
+      uint32_t masking_state = cpu_enter_critical();
+      pending |= (1UL << task_id);
+      cpu_exit_critical(masking_state);
+   }
+}
+
+/**
+ * @brief Returns true if tick a is at or after tick b, across wrap-around.
+ */
+static bool tick_reached(ticktime_t a, ticktime_t b)
+{
+   return (int32_t)(a - b) >= 0;
+}
+
+/**
+ * @brief Inserts a timer into the queue, keeping it sorted by deadline.
+ */
+static void insert_timer(const SchedulerTimer *timer)
+{
+   uint8_t i = num_timers++;
+
+   while ((i > 0) && !tick_reached(timer->deadline, timers[i - 1].deadline))
+   {
+      timers[i] = timers[i - 1];
+      i--;
+   }
+   timers[i] = *timer;
+}
+
+/**
+ * @brief Removes the timer of a task from the queue, if any.
+ */
+static void remove_timer(uint8_t task_id)
+{
+   for (uint8_t i = 0; i < num_timers; i++)
+   {
+      if (timers[i].task_id == task_id)
+      {
+         for (uint8_t j = i + 1; j < num_timers; j++)
+         {
+            timers[j - 1] = timers[j];
+         }
+         num_timers--;
+         return;
+      }
+   }
+}
+
+/**
+ * @brief Schedules a task to be posted after a delay, optionally periodically.
+ *
+ * A task has at most one timer; starting it again replaces the previous
+ * one. Must be called from thread context.
+ *
+ * @param task_id      Task to post.
+ * @param delay_ticks  SysTick ticks until the first posting.
+ * @param period_ticks Ticks between subsequent postings, 0 for one shot.
+ * @return bool false if the task id is unknown or the queue is full.
+ */
+bool scheduler_start_timer(uint8_t task_id, uint32_t delay_ticks, uint32_t period_ticks)
+{
+   if (task_id >= num_tasks)
+   {
+      return false;
+   }
+
+   remove_timer(task_id);
+   if (num_timers >= SCHED_MAX_TIMERS)
+   {
+      return false;
+   }
+
+   SchedulerTimer timer = {
+      .deadline = get_current_tick() + delay_ticks,
+      .period = period_ticks,
+      .task_id = task_id
+   };
+   insert_timer(&timer);
+   return true;
+}
+
+/**
+ * @brief Cancels the timer of a task. Already posted events still run.
+ *
+ * @param task_id Task whose timer is removed.
+ */
+void scheduler_stop_timer(uint8_t task_id)
+{
+   remove_timer(task_id);
+}
+
+/**
+ * @brief Posts the tasks of all expired timers and re-arms periodic ones.
+ *
+ * A periodic timer keeps its phase: the next deadline is derived from the
+ * previous one, not from the time it was serviced.
+ */
+static void expire_timers(void)
+{
+   ticktime_t now = get_current_tick();
+
+   while ((num_timers > 0) && tick_reached(now, timers[0].deadline))
+   {
+      SchedulerTimer timer = timers[0];
+
+      for (uint8_t j = 1; j < num_timers; j++)
+      {
+         timers[j - 1] = timers[j];
+      }
+      num_timers--;
+
+      scheduler_post(timer.task_id);
+      if (timer.period != 0)
+      {
+         timer.deadline += timer.period;
+         if (tick_reached(now, timer.deadline))
+         {
+            timer.deadline = now + timer.period;  // Missed periods are skipped
+         }
+         insert_timer(&timer);
+      }
+   }
+}
+
+/**
+ * @brief Runs one task and accounts its execution time.
+ */
+static void run_task(SchedulerTask *task)
+{
+   uint32_t start = get_time_us();
+   task->function();
+   uint32_t elapsed = get_time_us() - start;
+
+   task->runs++;
+   task->run_time_us += elapsed;
+   if (elapsed > task->max_time_us)
+   {
+      task->max_time_us = elapsed;
+   }
+   stats.busy_us += elapsed;
+}
+
+/**
+ * @brief Runs every task that is pending, until none is left.
+ *
+ * Tasks posted while a pass is running are picked up by the next pass.
+ *
+ * @return bool true if at least one task ran.
+ */
+bool scheduler_dispatch(void)
+{
+   bool ran = false;
+
+   while (1)
+   {
+      expire_timers();
+
+      uint32_t masking_state = cpu_enter_critical();
+      uint32_t ready = pending;
+      pending = 0;
+      cpu_exit_critical(masking_state);
+
+      if (ready == 0)
+      {
+         return ran;
+      }
+
+      for (uint8_t i = 0; i < num_tasks; i++)
+      {
+         if (ready & (1UL << i))
+         {
+            run_task(&tasks[i]);
+         }
+      }
+      ran = true;
+   }
+}
+
+/**
+ * @brief Main loop: runs pending tasks and sleeps when there are none.
+ *
+ * The check for pending work and WFI happen with interrupts masked, so an
+ * interrupt that posts a task just before sleeping wakes the core
+ * immediately instead of being noticed one tick later.
+ *
+ * @note This function never returns.
+ */
+void run_scheduler(void)
+{
+   while (1)
+   {
+      scheduler_dispatch();
+
+      uint32_t start = get_time_us();
+      uint32_t masking_state = cpu_enter_critical();
+      bool idle = (pending == 0) &&
+                  ((num_timers == 0) || !tick_reached(get_current_tick(), timers[0].deadline));
+      if (idle)
+      {
+         cpu_sleep();
+      }
+      cpu_exit_critical(masking_state);
+
+      if (idle)
+      {
+         stats.sleep_us += get_time_us() - start;
+         stats.wakeups++;
+      }
+   }
+}
+
+/**
+ * @brief Returns the statistics of one task.
+ *
+ * @param task_id Task to query.
+ * @return const SchedulerTask* Task entry, or NULL if the id is unknown.
+ */
+const SchedulerTask *scheduler_get_task(uint8_t task_id)
+{
+   return (task_id < num_tasks) ? &tasks[task_id] : NULL;
+}
+
+/**
+ * @brief Copies the busy and sleep time totals.
+ *
+ * @param[out] out Statistics since Init_Scheduler().
+ */
+void scheduler_get_stats(SchedulerStats *out)
+{
+   *out = stats;
+}
+
+/**
+ * @brief Logs the run-time statistics of all tasks and the CPU duty cycle.
+ *        Compiled empty when LOG_LEVEL excludes INFO_LOG.
+ */
+void scheduler_report(void)
+{
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+   uint64_t total_us = stats.busy_us + stats.sleep_us;
+   uint32_t duty_permille = (total_us != 0) ? (uint32_t)((stats.busy_us * 1000) / total_us) : 0;
+
+   INFO_LOG("CPU awake %lu.%lu%% of %lu ms, %lu wakeups",
+            (unsigned long)(duty_permille / 10), (unsigned long)(duty_permille % 10),
+            (unsigned long)(total_us / 1000), (unsigned long)stats.wakeups);
+   for (uint8_t i = 0; i < num_tasks; i++)
+   {
+      INFO_LOG("  %-10s runs %lu total %lu us max %lu us", tasks[i].name,
+               (unsigned long)tasks[i].runs, (unsigned long)tasks[i].run_time_us,
+               (unsigned long)tasks[i].max_time_us);
+   }
+#endif
+}
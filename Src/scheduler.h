@@ -0,0 +1,66 @@
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    scheduler.h
+ * @brief   Cooperative event scheduler with timer events, deferred ISR work
+ *          and run-time accounting.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SCHED_MAX_TASKS  8   // Tasks are identified by a bit in the pending mask
+#define SCHED_MAX_TIMERS 8   // Entries of the timer-event queue
+#define SCHED_NO_TASK    0xFF
+
+typedef void (*TaskFunction)(void);
+
+/**
+ * @brief Run-time statistics of one task.
+ */
+typedef struct
+{
+   const char *name;
+   TaskFunction function;
+   uint32_t runs;          // Number of invocations
+   uint64_t run_time_us;   // Total execution time
+   uint32_t max_time_us;   // Longest single invocation
+} SchedulerTask;
+
+/**
+ * @brief Time spent running tasks and sleeping since Init_Scheduler().
+ */
+typedef struct
+{
+   uint64_t busy_us;
+   uint64_t sleep_us;
+   uint32_t wakeups;
+} SchedulerStats;
+
+void Init_Scheduler(void);
+uint8_t scheduler_add_task(const char *name, TaskFunction function);
+void scheduler_post(uint8_t task_id);
+bool scheduler_start_timer(uint8_t task_id, uint32_t delay_ticks, uint32_t period_ticks);
+void scheduler_stop_timer(uint8_t task_id);
+bool scheduler_dispatch(void);
+void run_scheduler(void);
+const SchedulerTask *scheduler_get_task(uint8_t task_id);
+void scheduler_get_stats(SchedulerStats *stats);
+void scheduler_report(void);
+
+#endif
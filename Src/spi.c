@@ -11,7 +11,13 @@
 /**
  * @file    spi.c
  * @brief	SPI2 peripheral driver and utility functions.
- *         
+ *
+ * Single registers are transferred by polling. Multi-byte sensor frames can
+ * be clocked by DMA1 channel 4 (SPI2_RX) and channel 5 (SPI2_TX) with the
+ * chip select held low for the whole burst; completion is signalled from
+ * the DMA transfer-complete interrupt. Chip selects are GPIOB outputs driven
+ * by software, so several slaves can share SPI2 (see SPI_Select()).
+ *
  * @author  Venetia Furtado
  * @date    12/02/2025
  * Reference:
@@ -20,7 +26,9 @@
 
 #include <stm32f091xc.h>
 #include <stdio.h>
+#include <string.h>
 #include "utilities.h"
+#include "spi.h"
 
 #define SCK          2
 #define MISO         2
@@ -32,13 +40,27 @@
 #define MSB_FIRST    0
 #define DATA         7
 #define SPI2_ENABLE  1
+#define DMA_IRQ_PRIORITY 1
+#define MASK(x) (1UL << (x))
+#define CS_RESET(x) (MASK(x) << 16) // BSRR reset half
+
+static uint8_t cs_pin = SPI_CS_DEFAULT;
+
+static uint8_t dma_tx[SPI_DMA_MAX_LEN + 1]; // Register address + dummy bytes
+static uint8_t dma_rx[SPI_DMA_MAX_LEN + 1]; // Byte received during address + data
+static uint8_t *dma_user_buf;
+static uint16_t dma_user_len;
+static SPI_Callback dma_callback;
+static volatile bool dma_busy = false;
+static volatile bool dma_success = false;
 
 /**
  * @brief Initializes SPI2 peripheral and associated GPIO pins.
  *
- * Configures GPIOB pins 12–15 for SPI2 alternate function (NSS, SCK, MISO, MOSI),
- * sets SPI2 as master with 12 MHz clock, CPOL=1, CPHA=0, MSB-first, 8-bit data,
- * and enables automatic NSS management.
+ * Configures GPIOB pins 13–15 for SPI2 alternate function (SCK, MISO, MOSI)
+ * and PB12 as the default software chip select, sets SPI2 as master with
+ * 12 MHz clock, CPOL=1, CPHA=0, MSB-first, 8-bit data, with software NSS
+ * management so that any GPIOB pin can act as chip select.
  * Code referenced from:
  * https://github.com/alexander-g-dean/ESF/blob/master/ST/Code/ch8/SPI/main.c
  */
@@ -48,12 +70,8 @@ void Init_SPI2(void)
    RCC->APB1ENR |= RCC_APB1ENR_SPI2EN;
    RCC->AHBENR |= RCC_AHBENR_GPIOBEN;
 
-   // GPIO B pin 12 in alternate function 0 (SPI2) for NSS
-   // Set mode field to 2 for alternate function
-   MODIFY_FIELD(GPIOB->MODER, GPIO_MODER_MODER12, ESF_GPIO_MODER_ALT_FUNC);
-   
-   // Select SPI2 (AF = 0) for alternate function
-   MODIFY_FIELD(GPIOB->AFR[1], GPIO_AFRH_AFSEL12, 0);
+   // GPIO B pin 12 as output, driven as the default chip select
+   SPI_Select(SPI_CS_DEFAULT);
 
    // GPIO B pin 13, 14, 15 in alternate function 0 (SPI2) for SCK, MISO, MOSI
    // Set each mode field to 2 for alternate function
@@ -70,9 +88,10 @@ void Init_SPI2(void)
    MODIFY_FIELD(SPI2->CR1, SPI_CR1_BR, MSTR_CLOCK);
    MODIFY_FIELD(SPI2->CR1, SPI_CR1_MSTR, MSTR_MODE); // Master mode
 
-   MODIFY_FIELD(SPI2->CR1, SPI_CR1_SSM, 0); 
-   MODIFY_FIELD(SPI2->CR1, SPI_CR1_SSI, 0); 
-   MODIFY_FIELD(SPI2->CR2, SPI_CR2_SSOE, 1); 
+   // Software slave management: internal NSS high, chip selects are GPIOs
+   MODIFY_FIELD(SPI2->CR1, SPI_CR1_SSM, 1); 
+   MODIFY_FIELD(SPI2->CR1, SPI_CR1_SSI, 1); 
+   MODIFY_FIELD(SPI2->CR2, SPI_CR2_SSOE, 0); 
 
    // Select first edge sample, active high clock
    MODIFY_FIELD(SPI2->CR1, SPI_CR1_CPHA, CPHA); 
@@ -88,6 +107,52 @@ void Init_SPI2(void)
    //MODIFY_FIELD(SPI2->CR2, SPI_CR2_NSSP, 1);
    // Enable SPI
    //MODIFY_FIELD(SPI2->CR1, SPI_CR1_SPE, SPI2_ENABLE);
+
+   // DMA1: channel 4 <- SPI2_RX, channel 5 -> SPI2_TX, 8-bit transfers
+   RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+   DMA1->CSELR &= ~(DMA_CSELR_C4S | DMA_CSELR_C5S);
+   DMA1->CSELR |= DMA1_CSELR_CH4_SPI2_RX | DMA1_CSELR_CH5_SPI2_TX;
+   DMA1_Channel4->CPAR = (uint32_t)&(SPI2->DR);
+   DMA1_Channel5->CPAR = (uint32_t)&(SPI2->DR);
+
+   NVIC_SetPriority(DMA1_Ch4_7_DMA2_Ch3_5_IRQn, DMA_IRQ_PRIORITY);
+   NVIC_ClearPendingIRQ(DMA1_Ch4_7_DMA2_Ch3_5_IRQn);
+   NVIC_EnableIRQ(DMA1_Ch4_7_DMA2_Ch3_5_IRQn);
+}
+
+/**
+ * @brief Selects the chip-select pin used by the following transfers.
+ *
+ * The pin is configured as a GPIOB output and driven high (inactive). It
+ * must not be one of the SPI2 (PB13–PB15) or I2C1 (PB8, PB9) pins, and
+ * must not be changed while a DMA burst is in progress.
+ *
+ * @param[in] pin GPIOB pin number of the slave's chip select.
+ */
+void SPI_Select(uint8_t pin)
+{
+   GPIOB->BSRR = MASK(pin);
+   GPIOB->MODER = (GPIOB->MODER & ~(GPIO_MODER_MODER0 << (pin * 2))) |
+                  (ESF_GPIO_MODER_OUTPUT << (pin * 2));
+   cs_pin = pin;
+}
+
+/**
+ * @brief Pulls the selected chip select low and enables SPI2.
+ */
+static void SPI_CS_Assert(void)
+{
+   GPIOB->BSRR = CS_RESET(cs_pin);
+   MODIFY_FIELD(SPI2->CR1, SPI_CR1_SPE, SPI2_ENABLE);
+}
+
+/**
+ * @brief Disables SPI2 and releases the selected chip select.
+ */
+static void SPI_CS_Release(void)
+{
+   MODIFY_FIELD(SPI2->CR1, SPI_CR1_SPE, 0);
+   GPIOB->BSRR = MASK(cs_pin);
 }
 
 /**
@@ -124,10 +189,6 @@ uint8_t SPI_Send_Receive_Byte(uint8_t d_out)
 /**
  * @brief Reads a single byte from a specified SPI register.
  *
- * This function enables the SPI2 peripheral, sends the register address,
- * receives the data byte from the SPI slave, and then disables the SPI2
- * peripheral.
- *
  * @param[in] register_addr  Address of the register to read from.
  * @return uint8_t           Value read from the specified register.
  */
@@ -135,22 +196,42 @@ uint8_t SPI_Read(const uint8_t register_addr)
 {
    uint8_t val = 0;
 
-   MODIFY_FIELD(SPI2->CR1, SPI_CR1_SPE, SPI2_ENABLE);
+   SPI_ReadBurst(register_addr, &val, 1);
 
-   SPI_Send_Receive_Byte(register_addr);
-   val = SPI_Send_Receive_Byte(0x00);
+   return val;
+}
 
-   MODIFY_FIELD(SPI2->CR1, SPI_CR1_SPE, 0);
+/**
+ * @brief Reads consecutive registers in one chip-select cycle.
+ *
+ * This function asserts the chip select and enables SPI2, sends the start
+ * register address once and then clocks out data_len bytes while the slave
+ * auto-increments its register pointer. The chip select is released only
+ * after the last byte has been received.
+ *
+ * @param[in]  register_addr  Address of the first register to read from.
+ * @param[out] bufp           Pointer to the buffer to store the read data.
+ * @param[in]  data_len       Number of bytes to read.
+ */
+void SPI_ReadBurst(const uint8_t register_addr, uint8_t *bufp, uint16_t data_len)
+{
+   SPI_CS_Assert();
 
-   return val;
+   SPI_Send_Receive_Byte(register_addr);
+   while (data_len--)
+   {
+      *bufp++ = SPI_Send_Receive_Byte(0x00);
+   }
+
+   SPI_CS_Release();
 }
 
 /**
  * @brief Writes a single byte to a specified SPI register.
  *
- * This function enables the SPI2 peripheral, sends the register address,
- * writes the provided data byte to the SPI slave, and then disables the SPI2
- * peripheral. The function returns the value received during the last SPI transfer.
+ * This function asserts the chip select, sends the register address,
+ * writes the provided data byte to the SPI slave, and then releases the
+ * chip select. The function returns the value received during the last SPI transfer.
  *
  * @param[in] register_addr  Address of the register to write to.
  * @param[in] data           Data byte to write to the register.
@@ -160,12 +241,139 @@ uint8_t SPI_Write(const uint8_t register_addr, const uint8_t data)
 {
    uint8_t val = 0;
 
-   MODIFY_FIELD(SPI2->CR1, SPI_CR1_SPE, SPI2_ENABLE);
+   SPI_CS_Assert();
 
    SPI_Send_Receive_Byte(register_addr);
    val = SPI_Send_Receive_Byte(data);
 
-   MODIFY_FIELD(SPI2->CR1, SPI_CR1_SPE, 0);
+   SPI_CS_Release();
 
    return val;
 }
+
+/**
+ * @brief Starts a DMA burst read of consecutive registers.
+ *
+ * The TX channel clocks out the register address followed by dummy bytes
+ * while the RX channel stores everything received. The chip select stays
+ * low until the DMA interrupt sees the last byte arrive, then the data is
+ * copied to bufp and the callback, if any, is invoked.
+ *
+ * @param[in]  register_addr  Address of the first register to read from.
+ * @param[out] bufp           Buffer to receive data_len bytes; must stay valid
+ *                            until the transfer completes.
+ * @param[in]  data_len       Number of bytes to read (1..SPI_DMA_MAX_LEN).
+ * @param[in]  callback       Completion callback, may be NULL.
+ * @return true if the burst was started, false if DMA is busy or
+ *         data_len is out of range.
+ */
+bool SPI_DMA_ReadBurst(const uint8_t register_addr, uint8_t *bufp, uint16_t data_len, SPI_Callback callback)
+{
+   if (dma_busy || (data_len == 0) || (data_len > SPI_DMA_MAX_LEN))
+   {
+      return false;
+   }
+
+   dma_busy = true;
+   dma_success = false;
+   dma_user_buf = bufp;
+   dma_user_len = data_len;
+   dma_callback = callback;
+
+   dma_tx[0] = register_addr;
+   memset(&dma_tx[1], 0x00, data_len);
+
+   // RX: peripheral to memory, memory increment, interrupt on complete/error
+   DMA1_Channel4->CCR = 0;
+   DMA1_Channel4->CMAR = (uint32_t)dma_rx;
+   DMA1_Channel4->CNDTR = data_len + 1;
+   DMA1_Channel4->CCR = DMA_CCR_MINC | DMA_CCR_TCIE | DMA_CCR_TEIE;
+
+   // TX: memory to peripheral, memory increment
+   DMA1_Channel5->CCR = 0;
+   DMA1_Channel5->CMAR = (uint32_t)dma_tx;
+   DMA1_Channel5->CNDTR = data_len + 1;
+   DMA1_Channel5->CCR = DMA_CCR_MINC | DMA_CCR_DIR;
+
+   DMA1->IFCR = DMA_IFCR_CGIF4 | DMA_IFCR_CGIF5;
+
+   // Enable order from RM0091: RX DMA, channels, TX DMA, then SPI
+   SPI2->CR2 |= SPI_CR2_RXDMAEN;
+   DMA1_Channel4->CCR |= DMA_CCR_EN;
+   DMA1_Channel5->CCR |= DMA_CCR_EN;
+   SPI2->CR2 |= SPI_CR2_TXDMAEN;
+   SPI_CS_Assert();
+
+   return true;
+}
+
+/**
+ * @brief DMA1 channel 4-7 interrupt handler.
+ *
+ * On SPI2_RX transfer complete (or transfer error) the channels are stopped,
+ * the chip select is released once the bus is idle, and the received data
+ * is handed to the caller.
+ */
+void DMA1_CH4_5_6_7_DMA2_CH3_4_5_IRQHandler(void)
+{
+   uint32_t isr = DMA1->ISR;
+
+   if ((isr & (DMA_ISR_TCIF4 | DMA_ISR_TEIF4)) == 0)
+   {
+      return;
+   }
+   DMA1->IFCR = DMA_IFCR_CGIF4 | DMA_IFCR_CGIF5;
+
+   DMA1_Channel4->CCR &= ~DMA_CCR_EN;
+   DMA1_Channel5->CCR &= ~DMA_CCR_EN;
+
+   // Wait for the last frame to leave the shift register
+   while (SPI2->SR & SPI_SR_BSY)
+      ;
+   SPI_CS_Release();
+   SPI2->CR2 &= ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+
+   dma_success = ((isr & DMA_ISR_TEIF4) == 0);
+   if (dma_success)
+   {
+      memcpy(dma_user_buf, &dma_rx[1], dma_user_len);
+   }
+   dma_busy = false;
+
+   if (dma_callback != NULL)
+   {
+      dma_callback(dma_success);
+   }
+}
+
+/**
+ * @brief Checks whether a DMA burst is in progress.
+ *
+ * @return true while a burst started by SPI_DMA_ReadBurst() is running.
+ */
+bool SPI_DMA_Is_Busy(void)
+{
+   return dma_busy;
+}
+
+/**
+ * @brief Sleeps until the current DMA burst has completed.
+ *
+ * Interrupts are masked around the busy check so that the completion
+ * interrupt cannot slip in between the check and __WFI().
+ *
+ * @return true if the last burst completed without a DMA error.
+ */
+bool SPI_DMA_Wait(void)
+{
+   uint32_t masking_state = __get_PRIMASK();
+   __disable_irq();
+   while (dma_busy)
+   {
+      __WFI();
+      __enable_irq();
+      __disable_irq();
+   }
+   __set_PRIMASK(masking_state);
+   return dma_success;
+}
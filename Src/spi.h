@@ -21,9 +21,23 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#define SPI_DMA_MAX_LEN 32 // Largest DMA burst, covers the 26-byte calibration block
+#define SPI_CS_DEFAULT  12 // PB12, chip select of the on-board sensor
+
+/**
+ * @brief Completion callback for DMA bursts, invoked from the DMA interrupt.
+ */
+typedef void (*SPI_Callback)(bool success);
 
 void Init_SPI2(void);
+void SPI_Select(uint8_t pin);
 uint8_t SPI_Read(const uint8_t register_addr);
+void SPI_ReadBurst(const uint8_t register_addr, uint8_t *bufp, uint16_t data_len);
 uint8_t SPI_Write(const uint8_t register_addr, const uint8_t data);
+bool SPI_DMA_ReadBurst(const uint8_t register_addr, uint8_t *bufp, uint16_t data_len, SPI_Callback callback);
+bool SPI_DMA_Is_Busy(void);
+bool SPI_DMA_Wait(void);
 
 #endif
\ No newline at end of file
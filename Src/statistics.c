@@ -0,0 +1,397 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    statistics.c
+ * @brief   Multi-window rolling statistics of temperature, pressure and
+ *          humidity.
+ *
+ * Every window keeps an integer sum and sum of squares, updated by adding
+ * the item that enters and subtracting the item that leaves, and two
+ * monotonic deques whose fronts are the window minimum and maximum. Each
+ * sample therefore costs O(1), amortized, per window and history is never
+ * rescanned.
+ *
+ * The 1 minute window is exact over the last 60 samples. Every 60 samples
+ * it is closed into a minute block (sum, sum of squares, minimum and
+ * maximum), and the 10 minute and 1 hour windows slide over the last 10
+ * and 60 blocks; they advance once a minute and do not include the minute
+ * in progress. Keeping one hour of samples per channel would not fit the
+ * STM32F091's 32 KB of RAM, the blocks take a sixtieth of that.
+ *
+ * Values are stored relative to the first sample of each channel, so the
+ * squares of pressure (Pa x 256) stay well within 64 bits over an hour.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#define LOG_MODULE LOG_MODULE_STATISTICS
+#include <stdio.h>
+#include "statistics.h"
+#include "log.h"
+
+// History rings are a power of two no smaller than the longest window, so
+// an item is found from its sequence number with a mask, without a division.
+#define STATS_HISTORY_SIZE 64
+#define STATS_HISTORY_MASK (STATS_HISTORY_SIZE - 1)
+
+#define STATS_MINUTE_BLOCKS 60  // Blocks in the longest window
+
+/**
+ * @brief Sequence numbers of the window items that can still become its
+ *        minimum (or maximum), oldest first, with values monotonic.
+ */
+typedef struct
+{
+   uint8_t seq[STATS_HISTORY_SIZE];
+   uint8_t first;
+   uint8_t count;
+} MonoDeque;
+
+/**
+ * @brief Read-only view of the items a window slides over.
+ *
+ * A sample is an item whose minimum, maximum and sum are its value.
+ */
+typedef struct
+{
+   const int32_t *min;
+   const int32_t *max;
+   const int32_t *sum;
+   const uint64_t *sumsq;  // NULL: square of sum
+} StatsHistory;
+
+typedef struct
+{
+   int64_t sum;
+   uint64_t sumsq;
+   uint8_t length;         // Items in the window
+   MonoDeque min;
+   MonoDeque max;
+} StatsWindow;
+
+typedef struct
+{
+   int32_t reference;                         // First sample
+   int32_t sample[STATS_HISTORY_SIZE];        // Relative to reference
+   int32_t block_min[STATS_HISTORY_SIZE];
+   int32_t block_max[STATS_HISTORY_SIZE];
+   int32_t block_sum[STATS_HISTORY_SIZE];
+   uint64_t block_sumsq[STATS_HISTORY_SIZE];
+   StatsWindow window[STATS_PERIOD_COUNT];
+} ChannelStats;
+
+// Window lengths, in samples for STATS_1_MIN and in minute blocks otherwise
+static const uint8_t window_size[STATS_PERIOD_COUNT] = { STATS_SAMPLES_PER_MINUTE, 10, STATS_MINUTE_BLOCKS };
+
+static ChannelStats channels[STATS_CHANNEL_COUNT];
+static uint8_t sample_seq;         // Sequence number of the next sample
+static uint8_t block_seq;          // Sequence number of the next minute block
+static uint8_t minute_samples;     // Samples since the last block was closed
+static bool started;
+
+/**
+ * @brief Appends an item to a deque, first removing the items it dominates.
+ *
+ * @param d        Deque.
+ * @param values   Item values indexed by sequence number.
+ * @param seq      Sequence number of the new item.
+ * @param keep_max true for a maximum deque, false for a minimum deque.
+ */
+static void deque_push(MonoDeque *d, const int32_t *values, uint8_t seq, bool keep_max)
+{
+   int32_t value = values[seq & STATS_HISTORY_MASK];
+
+   while (d->count != 0)
+   {
+      int32_t back = values[d->seq[(d->first + d->count - 1) & STATS_HISTORY_MASK] & STATS_HISTORY_MASK];
+      if (keep_max ? (back > value) : (back < value))
+      {
+         break;
+      }
+      d->count--;
+   }
+   d->seq[(d->first + d->count) & STATS_HISTORY_MASK] = seq;
+   d->count++;
+}
+
+/**
+ * @brief Removes the items older than the oldest item of the window.
+ */
+static void deque_expire(MonoDeque *d, uint8_t oldest)
+{
+   while ((d->count != 0) && ((int8_t)(d->seq[d->first] - oldest) < 0))
+   {
+      d->first = (d->first + 1) & STATS_HISTORY_MASK;
+      d->count--;
+   }
+}
+
+static uint64_t item_sumsq(const StatsHistory *h, uint8_t slot)
+{
+   return (h->sumsq != NULL) ? h->sumsq[slot] : (uint64_t)((int64_t)h->sum[slot] * h->sum[slot]);
+}
+
+/**
+ * @brief Slides a window by one item.
+ *
+ * The item must already be stored in the history; the item that leaves,
+ * size items earlier, is still there because the history is longer than
+ * any window.
+ *
+ * @param w    Window.
+ * @param h    Items of the window.
+ * @param seq  Sequence number of the new item.
+ * @param size Window length in items.
+ */
+static void window_push(StatsWindow *w, const StatsHistory *h, uint8_t seq, uint8_t size)
+{
+   uint8_t slot = seq & STATS_HISTORY_MASK;
+   uint8_t oldest = (uint8_t)(seq - size + 1);
+
+   if (w->length == size)
+   {
+      uint8_t leaving = (uint8_t)(seq - size) & STATS_HISTORY_MASK;
+      w->sum -= h->sum[leaving];
+      w->sumsq -= item_sumsq(h, leaving);
+   }
+   else
+   {
+      w->length++;
+   }
+   w->sum += h->sum[slot];
+   w->sumsq += item_sumsq(h, slot);
+
+   deque_push(&w->min, h->min, seq, false);
+   deque_push(&w->max, h->max, seq, true);
+   deque_expire(&w->min, oldest);
+   deque_expire(&w->max, oldest);
+}
+
+static int32_t window_min(const StatsWindow *w, const int32_t *values)
+{
+   return values[w->min.seq[w->min.first] & STATS_HISTORY_MASK];
+}
+
+static int32_t window_max(const StatsWindow *w, const int32_t *values)
+{
+   return values[w->max.seq[w->max.first] & STATS_HISTORY_MASK];
+}
+
+/**
+ * @brief Closes the last 60 samples of a channel into a minute block and
+ *        slides the block windows.
+ */
+static void close_minute(ChannelStats *c)
+{
+   const StatsWindow *minute = &c->window[STATS_1_MIN];
+   const StatsHistory blocks = { c->block_min, c->block_max, c->block_sum, c->block_sumsq };
+   uint8_t slot = block_seq & STATS_HISTORY_MASK;
+
+   c->block_min[slot] = window_min(minute, c->sample);
+   c->block_max[slot] = window_max(minute, c->sample);
+   c->block_sum[slot] = (int32_t)minute->sum;
+   c->block_sumsq[slot] = minute->sumsq;
+
+   for (uint8_t p = STATS_10_MIN; p < STATS_PERIOD_COUNT; p++)
+   {
+      window_push(&c->window[p], &blocks, block_seq, window_size[p]);
+   }
+}
+
+/**
+ * @brief Clears all windows.
+ */
+void Init_Statistics(void)
+{
+   for (uint8_t i = 0; i < STATS_CHANNEL_COUNT; i++)
+   {
+      channels[i] = (ChannelStats){ 0 };
+   }
+   sample_seq = 0;
+   block_seq = 0;
+   minute_samples = 0;
+   started = false;
+}
+
+/**
+ * @brief Adds one sample of all three channels to every window.
+ *
+ * @param data Sample, in the fixed-point units of BME280_FixedData.
+ * @return bool true if the sample completed a minute block, which
+ *         statistics_last_minute() then returns.
+ */
+bool statistics_add_sample(const BME280_FixedData *data)
+{
+   const int32_t value[STATS_CHANNEL_COUNT] = {
+      data->temperature, (int32_t)data->pressure, (int32_t)data->humidity
+   };
+
+   for (uint8_t i = 0; i < STATS_CHANNEL_COUNT; i++)
+   {
+      ChannelStats *c = &channels[i];
+      const StatsHistory samples = { c->sample, c->sample, c->sample, NULL };
+
+      if (!started)
+      {
+         c->reference = value[i];
+      }
+      c->sample[sample_seq & STATS_HISTORY_MASK] = value[i] - c->reference;
+      window_push(&c->window[STATS_1_MIN], &samples, sample_seq, window_size[STATS_1_MIN]);
+   }
+   started = true;
+   sample_seq++;
+
+   if (++minute_samples == STATS_SAMPLES_PER_MINUTE)
+   {
+      for (uint8_t i = 0; i < STATS_CHANNEL_COUNT; i++)
+      {
+         close_minute(&channels[i]);
+      }
+      block_seq++;
+      minute_samples = 0;
+      return true;
+   }
+   return false;
+}
+
+/**
+ * @brief Returns the statistics of one channel over one window.
+ *
+ * The squared deviations are summed exactly around the rounded integer mean
+ * m, as sum of squares - 2 m sum + n m^2, so the variance is short of the
+ * true value only by the square of the rounding error, at most 1/4.
+ *
+ * @param channel Channel.
+ * @param period  Window.
+ * @param[out] result Receives the statistics.
+ * @return bool false if the window holds no samples yet.
+ */
+bool statistics_get(StatsChannel channel, StatsPeriod period, StatsResult *result)
+{
+   const ChannelStats *c;
+   const StatsWindow *w;
+   int64_t mean;
+   uint32_t n;
+
+   if ((channel >= STATS_CHANNEL_COUNT) || (period >= STATS_PERIOD_COUNT))
+   {
+      return false;
+   }
+   c = &channels[channel];
+   w = &c->window[period];
+   if (w->length == 0)
+   {
+      return false;
+   }
+
+   n = (period == STATS_1_MIN) ? w->length : (uint32_t)w->length * STATS_SAMPLES_PER_MINUTE;
+   mean = (w->sum >= 0) ? (w->sum + n / 2) / (int64_t)n : -((-w->sum + n / 2) / (int64_t)n);
+
+   result->mean = c->reference + (int32_t)mean;
+   if (period == STATS_1_MIN)
+   {
+      result->min = c->reference + window_min(w, c->sample);
+      result->max = c->reference + window_max(w, c->sample);
+   }
+   else
+   {
+      result->min = c->reference + window_min(w, c->block_min);
+      result->max = c->reference + window_max(w, c->block_max);
+   }
+   result->variance = ((int64_t)w->sumsq - 2 * mean * w->sum + (int64_t)n * mean * mean) / n;
+   result->count = n;
+   return true;
+}
+
+/**
+ * @brief Returns the minute block closed last.
+ *
+ * @param channel Channel.
+ * @param[out] block Receives the minimum, maximum and sum of the 60 samples.
+ * @return bool false if no minute has been closed yet.
+ */
+bool statistics_last_minute(StatsChannel channel, StatsBlock *block)
+{
+   const ChannelStats *c;
+   uint8_t slot = (uint8_t)(block_seq - 1) & STATS_HISTORY_MASK;
+
+   if ((channel >= STATS_CHANNEL_COUNT) || (channels[channel].window[STATS_1_HOUR].length == 0))
+   {
+      return false;
+   }
+   c = &channels[channel];
+   block->min = c->reference + c->block_min[slot];
+   block->max = c->reference + c->block_max[slot];
+   block->sum = c->block_sum[slot] + (int64_t)c->reference * STATS_SAMPLES_PER_MINUTE;
+   return true;
+}
+
+/**
+ * @brief Returns the standard deviation of a result, in its units.
+ *
+ * Integer square root of the variance, rounded down.
+ */
+uint32_t statistics_stddev(const StatsResult *result)
+{
+   uint64_t remainder = result->variance;
+   uint64_t root = 0;
+   uint64_t bit = 1ULL << 62;
+
+   while (bit > remainder)
+   {
+      bit >>= 2;
+   }
+   while (bit != 0)
+   {
+      if (remainder >= root + bit)
+      {
+         remainder -= root + bit;
+         root = (root >> 1) + bit;
+      }
+      else
+      {
+         root >>= 1;
+      }
+      bit >>= 2;
+   }
+   return (uint32_t)root;
+}
+
+/**
+ * @brief Logs every window of every channel.
+ */
+void statistics_report(void)
+{
+   static const uint8_t period_minutes[STATS_PERIOD_COUNT] = { 1, 10, 60 };
+
+   for (uint8_t p = 0; p < STATS_PERIOD_COUNT; p++)
+   {
+      StatsResult r;
+
+      if (statistics_get(STATS_TEMPERATURE, (StatsPeriod)p, &r))
+      {
+         LOG_EVENT(LOG_STATS_TEMPERATURE, period_minutes[p], r.mean, r.min, r.max,
+                   (int32_t)statistics_stddev(&r), (int32_t)r.count);
+      }
+      if (statistics_get(STATS_PRESSURE, (StatsPeriod)p, &r))
+      {
+         LOG_EVENT(LOG_STATS_PRESSURE, period_minutes[p], r.mean, r.min, r.max,
+                   (int32_t)statistics_stddev(&r), (int32_t)r.count);
+      }
+      if (statistics_get(STATS_HUMIDITY, (StatsPeriod)p, &r))
+      {
+         LOG_EVENT(LOG_STATS_HUMIDITY, period_minutes[p], r.mean, r.min, r.max,
+                   (int32_t)statistics_stddev(&r), (int32_t)r.count);
+      }
+   }
+}
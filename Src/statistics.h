@@ -0,0 +1,77 @@
+#ifndef __STATISTICS_H
+#define __STATISTICS_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    statistics.h
+ * @brief   Rolling mean, variance, minimum and maximum of the sensor
+ *          channels over several concurrent windows.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "bme280.h"
+
+#define STATS_SAMPLES_PER_MINUTE 60  // One sample per SysTick
+
+typedef enum
+{
+   STATS_TEMPERATURE,   // °C x 100
+   STATS_PRESSURE,      // Pa x 256
+   STATS_HUMIDITY,      // %RH x 1024
+   STATS_CHANNEL_COUNT
+} StatsChannel;
+
+typedef enum
+{
+   STATS_1_MIN,         // Last 60 samples, updated every sample
+   STATS_10_MIN,        // Last 10 complete minutes
+   STATS_1_HOUR,        // Last 60 complete minutes
+   STATS_PERIOD_COUNT
+} StatsPeriod;
+
+/**
+ * @brief Statistics of one channel over one window, in the units of the
+ *        corresponding BME280_FixedData field.
+ */
+typedef struct
+{
+   int32_t mean;
+   int32_t min;
+   int32_t max;
+   uint64_t variance;   // Population variance, units squared
+   uint32_t count;      // Samples in the window
+} StatsResult;
+
+/**
+ * @brief Minimum, maximum and sum of one channel over a block of samples,
+ *        in the units of the corresponding BME280_FixedData field.
+ */
+typedef struct
+{
+   int32_t min;
+   int32_t max;
+   int64_t sum;
+} StatsBlock;
+
+void Init_Statistics(void);
+bool statistics_add_sample(const BME280_FixedData *data);
+bool statistics_get(StatsChannel channel, StatsPeriod period, StatsResult *result);
+bool statistics_last_minute(StatsChannel channel, StatsBlock *block);
+uint32_t statistics_stddev(const StatsResult *result);
+void statistics_report(void);
+
+#endif
@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "utilities.h"
+#include "switch.h"
 
 #define MASK(x) (1UL << (x))
 #define SW1_POS (13) /*PC13 (User Button B1)*/
@@ -42,6 +43,7 @@
 
 
 bool switch_activated = false;
+static SwitchCallback switch_callback = NULL;
 
 /**
  * @brief Initializes the user switch B1 on PC13 as an external interrupt.
@@ -80,6 +82,19 @@ void Init_switch()
    __enable_irq();
 }
 
+/**
+ * @brief Registers the function called from the EXTI interrupt on a press.
+ *
+ * The callback runs in interrupt context and should only post work, e.g.
+ * with scheduler_post().
+ *
+ * @param callback Function to call, or NULL to disable.
+ */
+void switch_set_callback(SwitchCallback callback)
+{
+   switch_callback = callback;
+}
+
 /**
  * @brief Interrupt handler for external interrupts on lines 4 to 15.
  * This handler services interrupts for the user switch connected to PC13
@@ -96,6 +111,10 @@ void EXTI4_15_IRQHandler(void)
    {
       EXTI->PR |= EXTI_PR_PR13; /*clear pending request*/
       switch_activated = true;
+      if (switch_callback != NULL)
+      {
+         switch_callback(); /*defer the work to thread context*/
+      }
    }
    
    EXTI->PR = CLEAR_PENDING_REQUEST; /*Clear all other pending requests for this handler*/
@@ -21,7 +21,13 @@
  * @date    10/06/2025
  *
  */
+/**
+ * @brief Called from the EXTI interrupt each time switch B1 is pressed.
+ */
+typedef void (*SwitchCallback)(void);
+
 void Init_switch();
+void switch_set_callback(SwitchCallback callback);
 bool is_switch_pressed();
 bool was_switch_activated();
 
@@ -15,6 +15,13 @@
  * 
  * This file provides functions to initialize the SysTick timer, handle
  * its interrupts, and manage a global time counter (time_var).
+ *
+ * The tick counter is normally advanced by the SysTick interrupt. In
+ * low-power operation the core clock, and with it SysTick, stops between
+ * samples, so the tick is advanced by an external source (the RTC wakeup
+ * timer, see power.c) through external_tick() instead. SysTick then keeps
+ * running only while the core is awake and serves as the microsecond time
+ * base of get_time_us().
  * 
  * @author  Venetia Furtado
  * @date    12/02/2025
@@ -31,9 +38,12 @@
 #define MS 1000
 #define INTERVAL_MS 1000
 #define INTERVAL (MS / INTERVAL_MS)
+#define TICKS_PER_US (F_SYS_CLK / (DIVISION_FACTOR * 1000000L))
 
 extern void Set_Clocks_To_48MHz();
 ticktime_t time_var = 0;
+static volatile uint32_t systick_wraps = 0;    // SysTick reloads, for get_time_us()
+static volatile TickSource tick_source = TICK_SOURCE_SYSTICK;
 
 /**
  * @brief Initializes the SysTick timer to generate periodic interrupts.
@@ -63,11 +73,40 @@ void init_systick(void)
  *
  * This function is called automatically when the SysTick timer reaches zero.
  * It increments the global variable time_var, which has been used for
- * timing purposes such as delay and keeping time count since system startup.
+ * timing purposes such as delay and keeping time count since system startup,
+ * unless the tick is provided by an external source.
  */
 void SysTick_Handler(void)
 {
-   time_var++;
+   systick_wraps++;
+   if (tick_source == TICK_SOURCE_SYSTICK)
+   {
+      time_var++;
+   }
+}
+
+/**
+ * @brief Selects what advances the tick counter.
+ *
+ * @param source TICK_SOURCE_SYSTICK, or TICK_SOURCE_EXTERNAL when the
+ *               tick is driven through external_tick().
+ */
+void set_tick_source(TickSource source)
+{
+   tick_source = source;
+}
+
+/**
+ * @brief Advances the tick counter by one tick from an external source.
+ *
+ * Called from the interrupt of the external tick source.
+ */
+void external_tick(void)
+{
+   if (tick_source == TICK_SOURCE_EXTERNAL)
+   {
+      time_var++;
+   }
 }
 
 /**
@@ -98,3 +137,57 @@ uint32_t time_since_startup()
 	uint32_t time_now = time_var * INTERVAL_MS;
 	return time_now;
 }
+
+/**
+ * @brief Returns a free-running microsecond timestamp for measuring durations.
+ *
+ * Combines the number of SysTick reloads with the SysTick down-counter. The
+ * reload count is read on both sides of the counter so that a reload in
+ * between is noticed. Must be called with interrupts enabled, otherwise a
+ * pending reload is not accounted for. SysTick stops in STOP mode, so the
+ * timestamp counts time the core was awake. The value wraps after about
+ * 71 minutes; differences of two timestamps are valid across the wrap.
+ *
+ * @return uint32_t Awake time since init_systick() in µs, modulo 2^32.
+ */
+uint32_t get_time_us(void)
+{
+   uint32_t wraps;
+   uint32_t count;
+
+   do
+   {
+      wraps = systick_wraps;
+      count = SysTick->VAL;
+   } while (wraps != systick_wraps);
+
+   return wraps * (INTERVAL_MS * 1000UL) + (SysTick->LOAD - count) / TICKS_PER_US;
+}
+
+/**
+ * @brief Returns the raw SysTick down-counter, for systick_elapsed_us().
+ *
+ * @return uint32_t Current SysTick counter value.
+ */
+uint32_t systick_count(void)
+{
+   return SysTick->VAL;
+}
+
+/**
+ * @brief Time elapsed since a systick_count() reading.
+ *
+ * Usable with interrupts masked, as long as less than one SysTick period
+ * (1 s) has passed.
+ *
+ * @param start Value returned by systick_count().
+ * @return uint32_t Elapsed time in µs.
+ */
+uint32_t systick_elapsed_us(uint32_t start)
+{
+   uint32_t now = SysTick->VAL;
+   uint32_t ticks = (start >= now) ? (start - now) : (start + SysTick->LOAD + 1 - now);
+
+   return ticks / TICKS_PER_US;
+}
+
@@ -25,10 +25,21 @@
 
 typedef uint32_t ticktime_t;
 
+typedef enum
+{
+   TICK_SOURCE_SYSTICK,    // SysTick interrupt advances the tick
+   TICK_SOURCE_EXTERNAL    // external_tick() advances the tick
+} TickSource;
+
 void init_systick(void);
 void SysTick_Handler(void);
 void reset_timer();
 ticktime_t get_current_tick();
 uint32_t time_since_startup();
+void set_tick_source(TickSource source);
+void external_tick(void);
+uint32_t get_time_us(void);
+uint32_t systick_count(void);
+uint32_t systick_elapsed_us(uint32_t start);
 
 #endif
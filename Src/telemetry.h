@@ -0,0 +1,61 @@
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    telemetry.h
+ * @brief   Binary telemetry frames carrying one sample each.
+ *
+ * Frame layout, multi-byte fields little-endian:
+ *
+ *   | 0xA5 0x5A | type | sequence (2) | time_s (4) | temperature (2) |
+ *   | pressure (4) | humidity (4) | state | CRC-16 (2) |
+ *
+ * The CRC (crc.h) covers every byte from type to state. A receiver finds
+ * frames by looking for the sync bytes and checking the CRC, so frames can
+ * share the UART with text output.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "bme280.h"
+
+// Define to send a frame per sample instead of the per-sample text logs
+//#define TELEMETRY_BINARY
+
+#define TELEMETRY_SYNC0        0xA5
+#define TELEMETRY_SYNC1        0x5A
+#define TELEMETRY_TYPE_SAMPLE  0x01
+#define TELEMETRY_FRAME_SIZE   22
+
+/**
+ * @brief Contents of a sample frame.
+ */
+typedef struct
+{
+   uint16_t sequence;      // Incremented per frame, wraps
+   uint32_t time_s;        // Seconds since reset
+   int16_t temperature;    // °C x 100
+   uint32_t pressure;      // Pa x 256
+   uint32_t humidity;      // %RH x 1024
+   uint8_t state;          // FSMState
+} TelemetrySample;
+
+void telemetry_encode(const TelemetrySample *sample, uint8_t frame[TELEMETRY_FRAME_SIZE]);
+bool telemetry_decode(const uint8_t frame[TELEMETRY_FRAME_SIZE], TelemetrySample *sample);
+void telemetry_send(const BME280_FixedData *data, uint8_t state, uint32_t time_s);
+
+#endif
@@ -1,6 +1,7 @@
 /**
  * @file    timer.c
- * @brief   TIM7 initialization and interrupt handling for LED blinking.
+ * @brief   TIM7 initialization and interrupt handling for LED blinking,
+ *          and a free-running cycle counter on TIM14.
  * 
  * @author  Venetia Furtado
  * @date    12/02/2025
@@ -10,12 +11,17 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "utilities.h"
-#include "fsm.h"
+#include "timer.h"
+#include "cpu.h"
+#include "profiler.h"
 
 
 #define TIM7_PSC_VAL 47999
 #define TIM7_ARR_VAL 999
 
+static TimerCallback tim7_callback = NULL;
+static volatile uint16_t tim14_overflows;   // Upper 16 bits of TIM14_GetCount()
+
 /**
  * @brief Initializes TIM7.
  * 
@@ -57,15 +63,113 @@ void Init_TIM7(void)
 }
 
 /**
- * @brief TIM7 interrupt handler-fires every 3 seconds
+ * @brief Registers the function called from the TIM7 update interrupt.
+ *
+ * The callback runs in interrupt context and should only post work, e.g.
+ * with scheduler_post().
+ *
+ * @param callback Function to call, or NULL to disable.
+ */
+void TIM7_SetCallback(TimerCallback callback)
+{
+   tim7_callback = callback;
+}
+
+/**
+ * @brief Sets the TIM7 period.
+ *
+ * @param arr Auto-reload value; the period is arr + 1 milliseconds.
+ */
+void TIM7_SetPeriod(uint16_t arr)
+{
+   TIM7->ARR = arr;
+}
+
+/**
+ * @brief TIM7 interrupt handler, fires at the end of every LED period.
  */
 void TIM7_IRQHandler(void)
 {
+   PROF_BEGIN(PROF_SCOPE_TIM7_IRQ);
+
    // Check if update interrupt flag is set
    if (TIM7->SR & TIM_SR_UIF)
    {
-      TIM7->ARR = blink_frequency();
-      blink_LED();
       TIM7->SR &= ~TIM_SR_UIF; // Clear interrupt flag
+      if (tim7_callback != NULL)
+      {
+         tim7_callback(); // Defer the LED update to thread context
+      }
+   }
+   PROF_END(PROF_SCOPE_TIM7_IRQ);
+}
+
+/**
+ * @brief Starts TIM14 as a free-running counter of core clock cycles.
+ *
+ * TIM14 is a 16-bit timer; its update interrupt, every 65536 cycles
+ * (1.37 ms), counts the overflows that extend it to 32 bits, which wrap
+ * after 89 s. Init_Power() borrows TIM14 to calibrate the LSI and stops
+ * it, so this must be called after Init_Power(). TIM14 does not count in
+ * STOP mode.
+ *
+ * Reference:
+ * 1. RM0091 Reference manual - Chapter 19 (TIM14)
+ */
+void Init_TIM14_Counter(void)
+{
+   RCC->APB1ENR |= RCC_APB1ENR_TIM14EN;
+
+   TIM14->CR1 = 0;
+   TIM14->CCER = 0;
+   TIM14->OR = 0;
+   TIM14->PSC = 0;
+   TIM14->ARR = 0xFFFF;
+   TIM14->CNT = 0;
+   TIM14->EGR = TIM_EGR_UG;
+   TIM14->SR = 0;
+   tim14_overflows = 0;
+
+   TIM14->DIER = TIM_DIER_UIE;
+   NVIC_SetPriority(TIM14_IRQn, 0);
+   NVIC_ClearPendingIRQ(TIM14_IRQn);
+   NVIC_EnableIRQ(TIM14_IRQn);
+
+   TIM14->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief Returns the number of core clock cycles counted by TIM14.
+ *
+ * Callable from interrupt handlers. An overflow whose interrupt has not
+ * run yet, because interrupts are masked or a handler is executing, is
+ * detected from the pending update flag.
+ */
+uint32_t TIM14_GetCount(void)
+{
+   uint32_t masking_state = cpu_enter_critical();
+   uint16_t high = tim14_overflows;
+   uint16_t low = TIM14->CNT;
+
+   if (TIM14->SR & TIM_SR_UIF)
+   {
+      // Overflow not counted yet: CNT may have been read before or after it
+      low = TIM14->CNT;
+      high++;
+   }
+   cpu_exit_critical(masking_state);
+
+   return ((uint32_t)high << 16) | low;
+}
+
+/**
+ * @brief TIM14 interrupt handler, counts counter overflows.
+ */
+void TIM14_IRQHandler(void)
+{
+   if (TIM14->SR & TIM_SR_UIF)
+   {
+      TIM14->SR &= ~TIM_SR_UIF;
+      tim14_overflows++;
    }
 }
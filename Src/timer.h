@@ -3,13 +3,28 @@
 
 /**
  * @file    timer.h
- * @brief   TIM7 timer interface for periodic LED control.
+ * @brief   TIM7 timer interface for periodic LED control, and the TIM14
+ *          cycle counter used by the profiler.
  * 
  * @author  Venetia Furtado
  * @date    12/02/2025
  *
  */
 
+#include <stdint.h>
+
+/**
+ * @brief Called from the TIM7 update interrupt at the end of each period.
+ */
+typedef void (*TimerCallback)(void);
+
 void Init_TIM7(void);
+void TIM7_SetCallback(TimerCallback callback);
+void TIM7_SetPeriod(uint16_t arr);
+
+#define TIM14_COUNTER_HZ 48000000UL   // One count per core clock cycle
+
+void Init_TIM14_Counter(void);
+uint32_t TIM14_GetCount(void);
 
 #endif
\ No newline at end of file
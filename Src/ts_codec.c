@@ -0,0 +1,268 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    ts_codec.c
+ * @brief   Delta-of-delta, zig-zag varint encoding of sample blocks.
+ *
+ * Each field of a sample (time in s, °C x 100, Pa x 256, %RH x 1024) is
+ * treated as an integer sequence:
+ *  - the first sample of a block is stored as is,
+ *  - the second as the difference from the first,
+ *  - every later one as the change of that difference (delta-of-delta).
+ * A sensor sampled at a fixed rate gives a time delta-of-delta of 0 and
+ * slowly varying channels give values near 0, which the zig-zag mapping
+ * (0, -1, 1, -2 ... to 0, 1, 2, 3 ...) and a little-endian base-128 varint
+ * store in one byte each; pressure, whose low byte is a fraction of a
+ * pascal, usually takes two. A typical sample takes 5 to 6 bytes instead
+ * of 16, block header and absolute first sample included.
+ *
+ * Block layout: byte 0 holds the sample count, then the encoded samples.
+ * Unused bytes at the end of the block are zero.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <string.h>
+#include "ts_codec.h"
+
+#define TS_HEADER_SIZE 1
+
+static uint32_t zigzag_encode(int32_t v)
+{
+   return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t v)
+{
+   return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+/**
+ * @brief Writes a varint.
+ *
+ * @return uint8_t Number of bytes written, 1 to 5.
+ */
+static uint8_t varint_put(uint8_t *out, uint32_t v)
+{
+   uint8_t n = 0;
+
+   while (v >= 0x80)
+   {
+      out[n++] = (uint8_t)(v | 0x80);
+      v >>= 7;
+   }
+   out[n++] = (uint8_t)v;
+   return n;
+}
+
+/**
+ * @brief Reads a varint that must end before limit.
+ *
+ * @return bool false if the varint is truncated or too long.
+ */
+static bool varint_get(const uint8_t *block, uint16_t *pos, uint16_t limit, uint32_t *v)
+{
+   uint32_t result = 0;
+
+   for (uint8_t shift = 0; (shift < 35) && (*pos < limit); shift += 7)
+   {
+      uint8_t byte = block[(*pos)++];
+      result |= (uint32_t)(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+      {
+         *v = result;
+         return true;
+      }
+   }
+   return false;
+}
+
+static void sample_to_fields(const TsSample *sample, int32_t *fields)
+{
+   fields[0] = (int32_t)sample->time_s;
+   fields[1] = sample->data.temperature;
+   fields[2] = (int32_t)sample->data.pressure;
+   fields[3] = (int32_t)sample->data.humidity;
+}
+
+static void fields_to_sample(const int32_t *fields, TsSample *sample)
+{
+   sample->time_s = (uint32_t)fields[0];
+   sample->data.temperature = fields[1];
+   sample->data.pressure = (uint32_t)fields[2];
+   sample->data.humidity = (uint32_t)fields[3];
+}
+
+/**
+ * @brief Starts a new, empty block.
+ *
+ * @param enc   Encoder.
+ * @param block TS_BLOCK_SIZE bytes that receive the block.
+ */
+void ts_encoder_init(TsEncoder *enc, uint8_t *block)
+{
+   memset(block, 0, TS_BLOCK_SIZE);
+   memset(enc, 0, sizeof(*enc));
+   enc->block = block;
+   enc->used = TS_HEADER_SIZE;
+}
+
+/**
+ * @brief Appends a sample to the block.
+ *
+ * Differences are computed modulo 2^32, so any sequence round-trips.
+ *
+ * @param enc    Encoder.
+ * @param sample Sample to append.
+ * @return bool false if the block is full; the sample was not added and
+ *              belongs in the next block.
+ */
+bool ts_encode(TsEncoder *enc, const TsSample *sample)
+{
+   uint8_t count = enc->block[0];
+   uint8_t encoded[TS_MAX_SAMPLE];
+   uint8_t length = 0;
+   int32_t fields[TS_FIELDS];
+   int32_t delta[TS_FIELDS];
+
+   if (count == UINT8_MAX)
+   {
+      return false;
+   }
+
+   sample_to_fields(sample, fields);
+   for (uint8_t f = 0; f < TS_FIELDS; f++)
+   {
+      int32_t value;
+
+      delta[f] = (int32_t)((uint32_t)fields[f] - (uint32_t)enc->prev[f]);
+      if (count == 0)
+      {
+         value = fields[f];
+      }
+      else if (count == 1)
+      {
+         value = delta[f];
+      }
+      else
+      {
+         value = (int32_t)((uint32_t)delta[f] - (uint32_t)enc->delta[f]);
+      }
+      length += varint_put(&encoded[length], zigzag_encode(value));
+   }
+
+   if (enc->used + length > TS_BLOCK_SIZE)
+   {
+      return false;
+   }
+
+   memcpy(&enc->block[enc->used], encoded, length);
+   enc->used += length;
+   enc->block[0] = count + 1;
+   for (uint8_t f = 0; f < TS_FIELDS; f++)
+   {
+      enc->delta[f] = delta[f];
+      enc->prev[f] = fields[f];
+   }
+   return true;
+}
+
+/**
+ * @brief Returns the number of samples in a block.
+ */
+uint8_t ts_block_count(const uint8_t *block)
+{
+   return block[0];
+}
+
+/**
+ * @brief Positions a decoder at the first sample of a block.
+ */
+void ts_decoder_init(TsDecoder *dec, const uint8_t *block)
+{
+   dec->block = block;
+   dec->pos = TS_HEADER_SIZE;
+   dec->index = 0;
+}
+
+/**
+ * @brief Decodes the next sample of a block.
+ *
+ * @param dec Decoder.
+ * @param[out] sample Receives the sample.
+ * @return bool false at the end of the block or if the block is corrupt.
+ */
+bool ts_decode(TsDecoder *dec, TsSample *sample)
+{
+   int32_t fields[TS_FIELDS];
+
+   if (dec->index >= ts_block_count(dec->block))
+   {
+      return false;
+   }
+
+   for (uint8_t f = 0; f < TS_FIELDS; f++)
+   {
+      uint32_t raw;
+      int32_t value;
+
+      if (!varint_get(dec->block, &dec->pos, TS_BLOCK_SIZE, &raw))
+      {
+         return false;
+      }
+      value = zigzag_decode(raw);
+
+      if (dec->index == 0)
+      {
+         fields[f] = value;
+         dec->delta[f] = 0;
+      }
+      else
+      {
+         if (dec->index >= 2)
+         {
+            value = (int32_t)((uint32_t)dec->delta[f] + (uint32_t)value);
+         }
+         dec->delta[f] = value;
+         fields[f] = (int32_t)((uint32_t)dec->prev[f] + (uint32_t)value);
+      }
+      dec->prev[f] = fields[f];
+   }
+
+   dec->index++;
+   fields_to_sample(fields, sample);
+   return true;
+}
+
+/**
+ * @brief Decodes one sample of a block by its position in the block.
+ *
+ * @param block Block.
+ * @param index Sample position, 0 for the first sample.
+ * @param[out] sample Receives the sample.
+ * @return bool false if the block holds fewer than index + 1 samples.
+ */
+bool ts_block_read(const uint8_t *block, uint8_t index, TsSample *sample)
+{
+   TsDecoder dec;
+
+   ts_decoder_init(&dec, block);
+   for (uint16_t i = 0; i <= index; i++)
+   {
+      if (!ts_decode(&dec, sample))
+      {
+         return false;
+      }
+   }
+   return true;
+}
@@ -0,0 +1,74 @@
+#ifndef __TS_CODEC_H
+#define __TS_CODEC_H
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+
+/**
+ * @file    ts_codec.h
+ * @brief   Compressed time-series blocks of timestamped BME280 samples.
+ *
+ * Samples are packed into self-contained blocks of TS_BLOCK_SIZE bytes, so
+ * block n of an array of blocks starts at byte n x TS_BLOCK_SIZE and can be
+ * decoded on its own.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include "bme280.h"
+
+#define TS_BLOCK_SIZE   128  // Bytes per block, including the header
+#define TS_FIELDS       4    // Time, temperature, pressure, humidity
+#define TS_MAX_SAMPLE   (TS_FIELDS * 5)  // Worst-case encoded size of a sample
+
+/**
+ * @brief A sample with the time it was taken.
+ */
+typedef struct
+{
+   uint32_t time_s;
+   BME280_FixedData data;
+} TsSample;
+
+/**
+ * @brief State of a block being filled.
+ */
+typedef struct
+{
+   uint8_t *block;               // TS_BLOCK_SIZE bytes
+   uint16_t used;                // Bytes written, header included
+   int32_t prev[TS_FIELDS];      // Last sample
+   int32_t delta[TS_FIELDS];     // Last difference between samples
+} TsEncoder;
+
+/**
+ * @brief Read position inside a block.
+ */
+typedef struct
+{
+   const uint8_t *block;
+   uint16_t pos;
+   uint8_t index;                // Samples decoded so far
+   int32_t prev[TS_FIELDS];
+   int32_t delta[TS_FIELDS];
+} TsDecoder;
+
+void ts_encoder_init(TsEncoder *enc, uint8_t *block);
+bool ts_encode(TsEncoder *enc, const TsSample *sample);
+uint8_t ts_block_count(const uint8_t *block);
+void ts_decoder_init(TsDecoder *dec, const uint8_t *block);
+bool ts_decode(TsDecoder *dec, TsSample *sample);
+bool ts_block_read(const uint8_t *block, uint8_t index, TsSample *sample);
+
+#endif
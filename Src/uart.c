@@ -0,0 +1,153 @@
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+/**
+ * @file    uart.c
+ * @brief   USART2 transmit ring drained by the TXE interrupt.
+ *
+ * SystemInit() configures USART2 (PA2/PA3, 115200 baud) through
+ * Init_USART2(), whose __io_putchar() waits for every character. This file
+ * replaces the weak _write() of syscalls.c: printf output is copied into a
+ * RingBuffer and returns at once, and the USART2 interrupt moves one byte
+ * to TDR per TXE event. The main loop is the only producer and the
+ * interrupt handler the only consumer, so no locking is needed.
+ *
+ * When the buffer is full the bytes that do not fit are dropped and
+ * counted; logging never waits for the line. UART_TX_Space() lets a caller
+ * check for room before a large burst.
+ *
+ * DMA is not used: the USART2 TX request is on DMA1 channel 4, which the
+ * SPI2 backend already uses for RX.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ * Reference:
+ * 1. RM0091 Reference manual, section 27 USART
+ */
+#include <stm32f091xc.h>
+#include "uart.h"
+#include "buffer.h"
+
+#define UART_IRQ_PRIORITY 3   // Below every timing-related interrupt
+
+extern int __io_putchar(int ch);
+
+RING_BUFFER_DEFINE(uart_tx_ring, uint8_t, UART_TX_BUFFER_SIZE);
+
+static bool tx_interrupt_enabled;
+static UART_Stats stats;
+
+/**
+ * @brief Switches the console output to the interrupt-driven ring.
+ *
+ * Output written before this call goes through the polled __io_putchar().
+ */
+void Init_UART_TX(void)
+{
+   ring_reset(&uart_tx_ring);
+   stats = (UART_Stats){ 0 };
+
+   USART2->CR1 &= ~USART_CR1_TXEIE;
+   NVIC_SetPriority(USART2_IRQn, UART_IRQ_PRIORITY);
+   NVIC_ClearPendingIRQ(USART2_IRQn);
+   NVIC_EnableIRQ(USART2_IRQn);
+   tx_interrupt_enabled = true;
+}
+
+/**
+ * @brief Queues bytes for transmission; called by the C library for stdout.
+ *
+ * @return int Always len: bytes that do not fit are dropped, not retried.
+ */
+int _write(int file, char *ptr, int len)
+{
+   uint16_t queued;
+   uint16_t used;
+
+   (void)file;
+   if (!tx_interrupt_enabled)
+   {
+      for (int i = 0; i < len; i++)
+      {
+         __io_putchar(ptr[i]);
+      }
+      return len;
+   }
+
+   queued = ring_push_bulk(&uart_tx_ring, ptr, (uint16_t)len);
+   stats.bytes_queued += queued;
+   stats.bytes_dropped += (uint32_t)len - queued;
+   used = ring_length(&uart_tx_ring);
+   if (used > stats.max_used)
+   {
+      stats.max_used = used;
+   }
+
+   // The handler clears TXEIE once the ring is empty; setting it here after
+   // the push restarts transmission. The handler cannot interrupt this
+   // read-modify-write in a way that loses the bit, it only ever clears it.
+   USART2->CR1 |= USART_CR1_TXEIE;
+   return len;
+}
+
+/**
+ * @brief Returns the free space of the transmit buffer in bytes.
+ */
+uint16_t UART_TX_Space(void)
+{
+   return ring_space(&uart_tx_ring);
+}
+
+/**
+ * @brief Returns true when every queued byte has left the shift register.
+ */
+bool UART_TX_Is_Idle(void)
+{
+   return ring_is_empty(&uart_tx_ring) && (USART2->ISR & USART_ISR_TC);
+}
+
+/**
+ * @brief Waits until all queued output has been sent, before a reset or
+ *        when the clocks are about to stop.
+ */
+void UART_TX_Flush(void)
+{
+   while (!UART_TX_Is_Idle())
+      ;
+}
+
+/**
+ * @brief Copies the transmit counters.
+ */
+void UART_Get_Stats(UART_Stats *out)
+{
+   *out = stats;
+}
+
+/**
+ * @brief USART2 interrupt: sends the next queued byte on TXE and stops the
+ *        interrupt when the ring is empty.
+ */
+void USART2_IRQHandler(void)
+{
+   uint8_t byte;
+
+   if ((USART2->CR1 & USART_CR1_TXEIE) && (USART2->ISR & USART_ISR_TXE))
+   {
+      if (ring_pop(&uart_tx_ring, &byte) == 1)
+      {
+         USART2->TDR = byte;
+      }
+      else
+      {
+         USART2->CR1 &= ~USART_CR1_TXEIE;
+      }
+   }
+}
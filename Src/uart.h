@@ -0,0 +1,47 @@
+#ifndef __UART_H__
+#define __UART_H__
+
+/*******************************************************************************
+ * Copyright (c) 2023 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ * Venetia Furtado and the University of Colorado are not liable for
+ * any misuse of this material.
+ * ****************************************************************************/
+/**
+ * @file    uart.h
+ * @brief   Interrupt-driven, non-blocking transmit path of the USART2
+ *          console used by printf.
+ *
+ * @author  Venetia Furtado
+ * @date    10/16/2026
+ *
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+// A USER state report is queued in one FSM pass. With 24 archived hours and
+// PROFILE it measures 3.9 KB on the host build; the margin covers wider
+// numbers and more scheduler tasks.
+#define UART_TX_BUFFER_SIZE 4608
+
+/**
+ * @brief Transmit counters since Init_UART_TX().
+ */
+typedef struct
+{
+   uint32_t bytes_queued;     // Accepted by _write()
+   uint32_t bytes_dropped;    // Discarded because the buffer was full
+   uint16_t max_used;         // Highest buffer occupancy seen
+} UART_Stats;
+
+void Init_UART_TX(void);
+uint16_t UART_TX_Space(void);
+bool UART_TX_Is_Idle(void);
+void UART_TX_Flush(void);
+void UART_Get_Stats(UART_Stats *stats);
+
+#endif